@@ -17,6 +17,14 @@ public:
     BinaryLoader(MemoryManager* heap, const std::vector<uint8_t>& data);
     proto_t load_module();
 
+    // Bảng tên global của module (thứ tự = slot mà GET_GLOBAL / SET_GLOBAL dùng), có sau load_module()
+    inline std::vector<string_t>& get_global_names() noexcept {
+        return global_names_;
+    }
+    inline const std::vector<proto_t>& get_prototypes() const noexcept {
+        return loaded_protos_;
+    }
+
 private:
     // --- Patching Structure ---
     struct Patch {
@@ -28,10 +36,14 @@ private:
     MemoryManager* heap_;
     const std::vector<uint8_t>& data_;
     size_t cursor_ = 0;
+    uint32_t version_ = 0;
 
     std::vector<proto_t> loaded_protos_;
     std::vector<Patch> patches_;
 
+    std::vector<string_t> global_names_;
+    std::unordered_map<string_t, uint32_t> global_slots_;
+
     // --- Readers ---
     void check_can_read(size_t bytes);
     uint8_t  read_u8();
@@ -45,6 +57,10 @@ private:
     proto_t read_prototype(size_t current_proto_idx);
     
     void check_magic();
+    void read_global_names();
+    uint32_t resolve_global(string_t name);
+    void check_opcodes(const std::vector<uint8_t>& bytecode, string_t proto_name);
+    void link_globals(std::vector<uint8_t>& bytecode, const std::vector<Value>& constants);
     void link_prototypes();
 };
 
@@ -0,0 +1,21 @@
+#pragma once
+
+#include "common/pch.h"
+
+namespace meow {
+class Chunk;
+
+/**
+ * Tính "đáy cửa sổ gọi hàm" của một chunk: register thấp nhất mà cửa sổ của callee được phép
+ * đặt chồng lên. Với mọi lời gọi (CALL / CALL_VOID / INVOKE / TAIL_CALL), không register nào
+ * >= giá trị này còn được đọc sau khi lời gọi trả về (trừ dst, được ghi sau khi callee trả về).
+ *
+ * Phân tích liveness bảo thủ trên bytecode gốc (chạy trước khi gộp superinstruction):
+ *  - Chunk có SETUP_TRY: mọi register sống ở catch target được coi là sống ở mọi lệnh.
+ *  - Chunk có CLOSURE: upvalue có thể trỏ vào bất kỳ register nào, trả về num_registers.
+ *  - Bytecode không phân tích được (opcode lạ, lệnh cụt, nhảy lệch): trả về num_registers.
+ *
+ * @return Giá trị trong [0, num_registers]; num_registers nghĩa là cửa sổ luôn được dựng mới
+ */
+size_t compute_call_window_floor(const Chunk& chunk, size_t num_registers);
+}
@@ -3,8 +3,32 @@
 #include "common/pch.h"
 #include "common/definitions.h"
 #include "core/value.h"
+#include "bytecode/inline_cache.h"
 
 namespace meow {
+
+/**
+ * Một ô 16 byte của instruction stream đã giải mã. Mỗi lệnh bắt đầu ở đầu một record:
+ * 8 byte đầu là địa chỉ handler, sau đó là operand đã căn lề tự nhiên (u16 -> 2,
+ * địa chỉ u32 -> 4, immediate 64-bit và con trỏ inline cache -> 8). Lệnh có operand 8 byte chiếm 2 record.
+ */
+struct alignas(16) InstructionRecord {
+    uint8_t bytes_[16];
+};
+
+// Đọc operand đã căn lề trong stream (memcpy để tránh vi phạm strict aliasing, compile ra một lệnh load)
+template <typename T>
+inline T load_operand(const uint8_t* at) noexcept {
+    T value;
+    std::memcpy(&value, at, sizeof(T));
+    return value;
+}
+
+template <typename T>
+inline void store_operand(uint8_t* at, T value) noexcept {
+    std::memcpy(at, &value, sizeof(T));
+}
+
 class Chunk {
 public:
     Chunk() = default;
@@ -63,6 +87,9 @@ public:
         constant_pool_.push_back(value);
         return constant_pool_.size() - 1;
     }
+    inline const Value* get_constants() const noexcept {
+        return constant_pool_.data();
+    }
     inline return_t get_constant(size_t index) const noexcept {
         return constant_pool_[index];
     }
@@ -70,6 +97,14 @@ public:
         return constant_pool_[index];
     }
 
+    inline bool patch_u8(size_t offset, uint8_t value) noexcept {
+        if (offset >= code_.size()) return false;
+
+        code_[offset] = value;
+
+        return true;
+    }
+
     inline bool patch_u16(size_t offset, uint16_t value) noexcept {
         if (offset + 1 >= code_.size()) return false;
 
@@ -79,8 +114,61 @@ public:
         return true;
     }
 
+    // --- Decoded stream ---
+    // Giải mã code_ thành stream_ (gọi một lần lúc load, sau các pass sửa bytecode).
+    // Trả về false nếu bytecode hỏng (opcode lạ, lệnh bị cắt cụt, nhảy vào giữa lệnh).
+    bool decode();
+
+    // Ghi địa chỉ handler thật vào từng record. Làm lười ở lần đầu chunk được chạy,
+    // vì địa chỉ label chỉ biết được bên trong vòng dispatch.
+    void thread(const void* const* handlers) noexcept;
+
+    inline bool is_threaded() const noexcept {
+        return threaded_;
+    }
+    inline const uint8_t* get_stream() const noexcept {
+        return reinterpret_cast<const uint8_t*>(stream_.data());
+    }
+    inline size_t get_stream_size() const noexcept {
+        return stream_.size() * sizeof(InstructionRecord);
+    }
+
+    // Ánh xạ một vị trí trong stream về offset của lệnh tương ứng trong bytecode gốc
+    size_t source_offset(const uint8_t* ip) const noexcept;
+
+    // --- Inline caches ---
+    inline size_t get_property_cache_count() const noexcept {
+        return property_caches_.size();
+    }
+    inline size_t get_export_cache_count() const noexcept {
+        return export_caches_.size();
+    }
+
+    // --- Call window ---
+    // Cửa sổ của callee chỉ được đặt chồng lên register >= giá trị này của chunk gọi
+    // (xem bytecode/call_window.h). Mặc định: chưa phân tích, luôn dựng cửa sổ mới.
+    inline size_t get_call_window_floor() const noexcept {
+        return call_window_floor_;
+    }
+    inline void set_call_window_floor(size_t floor) noexcept {
+        call_window_floor_ = floor;
+    }
+
 private:
     std::vector<uint8_t> code_;
     std::vector<Value> constant_pool_;
+
+    std::vector<InstructionRecord> stream_;
+    std::vector<std::pair<uint32_t, uint32_t>> offset_map_; // {offset trong stream, offset trong code_}
+    bool threaded_ = false;
+
+    // Mỗi operand 'c' có một PropertyCache riêng. Trước khi thread, operand giữ chỉ số cache;
+    // thread() thay bằng con trỏ, lúc đó chunk đã nằm yên trong proto nên con trỏ không bị dời.
+    std::vector<PropertyCache> property_caches_;
+    std::vector<uint32_t> cache_sites_; // offset trong stream của từng operand 'c'
+    std::vector<ExportCache> export_caches_;
+    std::vector<uint32_t> export_sites_; // offset trong stream của từng operand 'e'
+
+    size_t call_window_floor_ = std::numeric_limits<size_t>::max();
 };
 }
\ No newline at end of file
@@ -0,0 +1,72 @@
+#pragma once
+
+#include "common/pch.h"
+#include "common/definitions.h"
+#include "core/value.h"
+#include "core/objects/shape.h"
+
+namespace meow {
+
+/**
+ * Một kết quả tra cứu property đã được ghi nhớ, gắn với shape của receiver.
+ * Shape id duy nhất và thuộc về đúng một class, nên khớp shape cũng là khớp class.
+ *  - slot_ != NOT_FOUND: field nằm ở slot_ của instance (GET_PROP / SET_PROP ghi đè)
+ *  - next_shape_ != nullptr: SET_PROP thêm field mới, instance chuyển sang next_shape_
+ *  - còn lại: GET_PROP trúng method_ của class, chỉ hợp lệ khi method version của class vẫn là version_
+ */
+struct PropertyCacheEntry {
+    uint32_t shape_id_ = 0; // 0: ô trống (shape id bắt đầu từ 1)
+    uint32_t slot_ = Shape::NOT_FOUND;
+    Shape* next_shape_ = nullptr;
+    Value method_;
+    uint32_t version_ = 0;
+};
+
+/**
+ * Inline cache của một lệnh GET_PROP / SET_PROP. Monomorphic khi chỉ có một entry,
+ * polymorphic tới MAX_ENTRIES shape; quá số đó thì site bị coi là megamorphic và
+ * luôn đi đường chậm.
+ */
+struct PropertyCache {
+    static constexpr uint32_t MAX_ENTRIES = 4;
+
+    uint32_t count_ = 0;
+    bool megamorphic_ = false;
+    std::array<PropertyCacheEntry, MAX_ENTRIES> entries_{};
+
+    inline const PropertyCacheEntry* lookup(uint32_t shape_id) const noexcept {
+        for (uint32_t i = 0; i < count_; ++i) {
+            if (entries_[i].shape_id_ == shape_id) return &entries_[i];
+        }
+        return nullptr;
+    }
+
+    // Ghi đè entry cùng shape (entry cũ đã hết hạn) hoặc thêm entry mới
+    inline void update(const PropertyCacheEntry& entry) noexcept {
+        for (uint32_t i = 0; i < count_; ++i) {
+            if (entries_[i].shape_id_ == entry.shape_id_) {
+                entries_[i] = entry;
+                return;
+            }
+        }
+        if (count_ < MAX_ENTRIES) {
+            entries_[count_++] = entry;
+        } else {
+            megamorphic_ = true;
+        }
+    }
+};
+
+/**
+ * Cache của một lệnh GET_EXPORT: module đọc ở site này và binding (owner, slot) đã resolve.
+ * Chỉ được điền khi module đã chạy xong, lúc đó bảng export đã ổn định; export_epoch_ bắt
+ * trường hợp hiếm một tên bị bind lại sau đó.
+ */
+struct ExportCache {
+    module_t module_ = nullptr;
+    module_t owner_ = nullptr;
+    uint32_t slot_ = 0;
+    uint32_t epoch_ = 0;
+};
+
+}
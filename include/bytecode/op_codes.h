@@ -51,6 +51,24 @@ enum class OpCode : unsigned char {
     EXPORT,
     GET_EXPORT,
     IMPORT_ALL,
+    // --- Quickened (rewritten in place by Machine::run, never emitted by masm) ---
+    ADD_II, ADD_FF, ADD_SS,
+    SUB_II, SUB_FF,
+    MUL_II, MUL_FF,
+    DIV_FF,
+    MOD_II,
+    EQ_II, EQ_FF, NEQ_II, NEQ_FF,
+    GT_II, GT_FF, GE_II, GE_FF,
+    LT_II, LT_FF, LE_II, LE_FF,
+    // --- Superinstructions (fused at load time, see bytecode/superinstructions.h) ---
+    LOAD_INT_ADD, MOVE_MOVE, GET_PROP_MOVE, LT_JUMP_IF_FALSE,
+    // --- Compare-and-branch (nhảy khi điều kiện đúng, không tạo bool trung gian) ---
+    JEQ, JNE, JLT, JLE,
+    JEQ_I, JNE_I, JLT_I, JLE_I, JGT_I, JGE_I,
+    // --- Tail call (thay frame hiện tại thay vì push frame mới) ---
+    TAIL_CALL,
+    // --- Gọi method trực tiếp (không tạo bound method) ---
+    INVOKE,
     // --- Metadata ---
     TOTAL_OPCODES
 };
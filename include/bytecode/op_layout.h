@@ -0,0 +1,120 @@
+#pragma once
+
+#include "common/pch.h"
+#include "bytecode/op_codes.h"
+
+namespace meow {
+
+/**
+ * Bố cục operand của từng opcode trong bytecode gốc, mỗi ký tự là một operand:
+ *  - 'r': u16 (register, chỉ số constant, số lượng...)
+ *  - 'q': 64-bit immediate (i64 / f64)
+ *  - 'a': u16 địa chỉ tuyệt đối trong chunk (catch target của SETUP_TRY)
+ *  - 'j': u16 đích nhảy tuyệt đối trong chunk
+ *  - 'c': inline cache, không có byte nào trong bytecode gốc (chỉ tồn tại trong stream đã giải mã)
+ *  - 'e': export cache, giống 'c' nhưng cho GET_EXPORT
+ *
+ * Superinstruction chỉ mô tả phần của lệnh đầu, lệnh thứ hai vẫn đứng riêng trong chunk.
+ */
+constexpr std::string_view operand_layout(OpCode op) noexcept {
+    switch (op) {
+        case OpCode::HALT:
+        case OpCode::POP_TRY:
+            return "";
+        case OpCode::LOAD_NULL:
+        case OpCode::LOAD_TRUE:
+        case OpCode::LOAD_FALSE:
+        case OpCode::CLOSE_UPVALUES:
+        case OpCode::RETURN:
+        case OpCode::THROW:
+        case OpCode::IMPORT_ALL:
+            return "r";
+        case OpCode::LOAD_INT:
+        case OpCode::LOAD_FLOAT:
+        case OpCode::LOAD_INT_ADD:
+            return "rq";
+        case OpCode::LOAD_CONST:
+        case OpCode::MOVE:
+        case OpCode::NEG:
+        case OpCode::NOT:
+        case OpCode::BIT_NOT:
+        case OpCode::GET_GLOBAL:
+        case OpCode::SET_GLOBAL:
+        case OpCode::GET_UPVALUE:
+        case OpCode::SET_UPVALUE:
+        case OpCode::CLOSURE:
+        case OpCode::GET_KEYS:
+        case OpCode::GET_VALUES:
+        case OpCode::NEW_CLASS:
+        case OpCode::NEW_INSTANCE:
+        case OpCode::INHERIT:
+        case OpCode::GET_SUPER:
+        case OpCode::IMPORT_MODULE:
+        case OpCode::EXPORT:
+        case OpCode::MOVE_MOVE:
+            return "rr";
+        case OpCode::CALL_VOID:
+        case OpCode::TAIL_CALL:
+        case OpCode::NEW_ARRAY:
+        case OpCode::NEW_HASH:
+        case OpCode::GET_INDEX:
+        case OpCode::SET_INDEX:
+        case OpCode::SET_METHOD:
+        case OpCode::LT_JUMP_IF_FALSE:
+            return "rrr";
+        case OpCode::GET_EXPORT:
+            return "rrre";
+        case OpCode::GET_PROP:
+        case OpCode::SET_PROP:
+        case OpCode::GET_PROP_MOVE:
+            return "rrrc";
+        case OpCode::CALL:
+            return "rrrr";
+        case OpCode::INVOKE:
+            return "rrrrrc";
+        case OpCode::JUMP:
+            return "j";
+        case OpCode::JUMP_IF_FALSE:
+        case OpCode::JUMP_IF_TRUE:
+            return "rj";
+        case OpCode::SETUP_TRY:
+            return "ar";
+        case OpCode::JEQ:
+        case OpCode::JNE:
+        case OpCode::JLT:
+        case OpCode::JLE:
+            return "rrj";
+        case OpCode::JEQ_I:
+        case OpCode::JNE_I:
+        case OpCode::JLT_I:
+        case OpCode::JLE_I:
+        case OpCode::JGT_I:
+        case OpCode::JGE_I:
+            return "rqj";
+        default:
+            break;
+    }
+    // Toán tử nhị phân (kể cả bản quickened): dst, r1, r2
+    return "rrr";
+}
+
+constexpr bool is_valid_opcode(uint8_t raw) noexcept {
+    return raw < static_cast<uint8_t>(OpCode::TOTAL_OPCODES);
+}
+
+// Opcode chỉ VM tự sinh ra (bản quickened, superinstruction), không được xuất hiện trong file bytecode
+constexpr bool is_internal_opcode(OpCode op) noexcept {
+    return op >= OpCode::ADD_II && op <= OpCode::LT_JUMP_IF_FALSE;
+}
+
+// Kích thước (byte, tính cả opcode) của một lệnh trong bytecode gốc
+constexpr size_t instruction_size(OpCode op) noexcept {
+    size_t size = 1;
+    for (char kind : operand_layout(op)) {
+        if (kind == 'c' || kind == 'e') continue;
+        size += (kind == 'q') ? 8 : 2;
+    }
+    return size;
+}
+
+}
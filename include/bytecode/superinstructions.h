@@ -0,0 +1,18 @@
+#pragma once
+
+#include "common/pch.h"
+
+namespace meow {
+class Chunk;
+
+/**
+ * Gộp các cặp lệnh hay đi liền nhau thành một superinstruction.
+ *
+ * Chỉ opcode của lệnh đầu bị ghi đè, byte của lệnh thứ hai được giữ nguyên,
+ * nên một lệnh nhảy rơi thẳng vào lệnh thứ hai vẫn chạy đúng. Handler gộp
+ * tự bỏ qua opcode của lệnh thứ hai và tiếp tục đọc operand của nó.
+ *
+ * @return Số chỗ đã được gộp trong chunk
+ */
+size_t fuse_superinstructions(Chunk& chunk) noexcept;
+}
@@ -8,8 +8,128 @@
 
 namespace meow {
 
+namespace detail {
+inline std::string_view trim_space(std::string_view sv) noexcept {
+    size_t left = 0;
+    while (left < sv.size() && std::isspace(static_cast<unsigned char>(sv[left]))) ++left;
+    size_t right = sv.size();
+    while (right > left && std::isspace(static_cast<unsigned char>(sv[right - 1]))) --right;
+    return sv.substr(left, right - left);
+}
+
+// Dấu + tiền tố 0x / 0o / 0b, dừng ở ký tự không hợp lệ đầu tiên, tràn thì bão hoà về min/max
+inline int64_t parse_int(std::string_view sv) noexcept {
+    using i64_limits = std::numeric_limits<int64_t>;
+    sv = trim_space(sv);
+
+    bool negative = false;
+    if (!sv.empty() && (sv[0] == '-' || sv[0] == '+')) {
+        negative = sv[0] == '-';
+        sv.remove_prefix(1);
+    }
+
+    int base = 10;
+    if (sv.size() >= 2 && sv[0] == '0') {
+        switch (sv[1]) {
+            case 'x': case 'X': base = 16; break;
+            case 'o': case 'O': base = 8; break;
+            case 'b': case 'B': base = 2; break;
+            default: break;
+        }
+        if (base != 10) sv.remove_prefix(2);
+    }
+
+    uint64_t magnitude = 0;
+    auto [end, ec] = std::from_chars(sv.data(), sv.data() + sv.size(), magnitude, base);
+    if (ec == std::errc::invalid_argument) return 0;
+    // |min| lớn hơn max đúng 1
+    const uint64_t limit = static_cast<uint64_t>(i64_limits::max()) + (negative ? 1 : 0);
+    if (ec == std::errc::result_out_of_range || magnitude > limit) {
+        return negative ? i64_limits::min() : i64_limits::max();
+    }
+    return static_cast<int64_t>(negative ? 0 - magnitude : magnitude);
+}
+
+// from_chars báo result_out_of_range cho cả tràn lên lẫn tràn xuống: ước lượng bậc của số để phân biệt
+// (chỉ gọi khi đã tràn, lúc đó bậc cách 0 rất xa nên ước lượng thô là đủ)
+inline bool float_text_overflows(std::string_view sv, bool hex) noexcept {
+    const int64_t digit_order = hex ? 4 : 1; // Mũ của hex là mũ 2 ('p'), của thập phân là mũ 10 ('e')
+    auto is_digit = [hex](char c) {
+        return hex ? std::isxdigit(static_cast<unsigned char>(c)) : std::isdigit(static_cast<unsigned char>(c));
+    };
+
+    int64_t order = 0;
+    bool significant = false;
+    size_t pos = 0;
+    for (; pos < sv.size() && is_digit(sv[pos]); ++pos) {
+        significant |= sv[pos] != '0';
+        if (significant) order += digit_order;
+    }
+    if (pos < sv.size() && sv[pos] == '.') {
+        for (++pos; pos < sv.size() && is_digit(sv[pos]); ++pos) {
+            if (significant) continue;
+            if (sv[pos] == '0') order -= digit_order;
+            else significant = true;
+        }
+    }
+    if (pos < sv.size() && std::tolower(static_cast<unsigned char>(sv[pos])) == (hex ? 'p' : 'e')) {
+        ++pos;
+        bool exponent_negative = pos < sv.size() && sv[pos] == '-';
+        if (pos < sv.size() && (sv[pos] == '-' || sv[pos] == '+')) ++pos;
+        int64_t exponent = 0;
+        auto [end, ec] = std::from_chars(sv.data() + pos, sv.data() + sv.size(), exponent);
+        if (ec == std::errc::result_out_of_range) return !exponent_negative;
+        order += exponent_negative ? -exponent : exponent;
+    }
+    return order > 0;
+}
+
+// Không phụ thuộc locale; nhận dấu +/-, inf / infinity / nan (không phân biệt hoa thường) và hex float 0x...
+inline double parse_float(std::string_view sv) noexcept {
+    sv = trim_space(sv);
+
+    bool negative = false;
+    if (!sv.empty() && (sv[0] == '-' || sv[0] == '+')) {
+        negative = sv[0] == '-';
+        sv.remove_prefix(1);
+    }
+
+    bool hex = sv.size() >= 2 && sv[0] == '0' && (sv[1] == 'x' || sv[1] == 'X');
+    if (hex) sv.remove_prefix(2);
+
+    double value = 0.0;
+    auto [end, ec] = std::from_chars(sv.data(), sv.data() + sv.size(), value,
+                                     hex ? std::chars_format::hex : std::chars_format::general);
+    if (ec == std::errc::invalid_argument) return 0.0;
+    if (ec == std::errc::result_out_of_range) {
+        value = float_text_overflows(sv, hex) ? std::numeric_limits<double>::infinity() : 0.0;
+    }
+    return negative ? -value : value;
+}
+}
+
+// Đủ cho int64 và float dạng ngắn nhất round-trip của to_chars (tối đa 24 ký tự)
+inline constexpr size_t NUMBER_BUFFER_SIZE = 32;
+using number_buffer_t = std::array<char, NUMBER_BUFFER_SIZE>;
+
+// Ghi số vào buffer của caller, không cấp phát: tạo ObjString thì đưa thẳng view cho
+// MemoryManager::new_string (chuỗi đã intern thì không cấp phát gì thêm)
+inline std::string_view format_int(number_buffer_t& buffer, int64_t value) noexcept {
+    auto [end, ec] = std::to_chars(buffer.data(), buffer.data() + buffer.size(), value);
+    return std::string_view(buffer.data(), static_cast<size_t>(end - buffer.data()));
+}
+
+inline std::string_view format_float(number_buffer_t& buffer, double value) noexcept {
+    if (std::isnan(value)) return "NaN";
+    if (std::isinf(value)) return (value > 0) ? "Infinity" : "-Infinity";
+    if (value == 0.0 && std::signbit(value)) return "-0.0";
+    auto [end, ec] = std::to_chars(buffer.data(), buffer.data() + buffer.size(), value);
+    return std::string_view(buffer.data(), static_cast<size_t>(end - buffer.data()));
+}
+
 inline int64_t to_int(param_t value) noexcept {
     using i64_limits = std::numeric_limits<int64_t>;
+    if (value.is_boxed_int()) return value.as_int();
     return value.visit(
         [](null_t) -> int64_t { return 0; },
         [](int_t i) -> int64_t { return i; },
@@ -19,99 +139,19 @@ inline int64_t to_int(param_t value) noexcept {
             return static_cast<int64_t>(r);
         },
         [](bool_t b) -> int64_t { return b ? 1 : 0; },
-        [](string_t s) -> int64_t {
-            std::string_view sv = s->c_str();
-
-            size_t left = 0;
-            while (left < sv.size() && std::isspace(static_cast<unsigned char>(sv[left]))) ++left;
-            size_t right = sv.size();
-            while (right > left && std::isspace(static_cast<unsigned char>(sv[right - 1]))) --right;
-            if (left >= right) return 0;
-            sv = sv.substr(left, right - left);
-
-            bool negative = false;
-            if (!sv.empty() && sv[0] == '-') {
-                negative = true;
-                sv.remove_prefix(1);
-            } else if (!sv.empty() && sv[0] == '+') {
-                sv.remove_prefix(1);
-            }
-
-            if (sv.size() >= 2) {
-                auto prefix = sv.substr(0, 2);
-                if (prefix == "0b" || prefix == "0B") {
-                    using ull = unsigned long long;
-                    ull acc = 0;
-                    const ull limit = static_cast<ull>(i64_limits::max());
-                    sv.remove_prefix(2);
-                    for (char c : sv) {
-                        if (c == '0' || c == '1') {
-                            int d = c - '0';
-                            if (acc > (limit - d) / 2) {
-                                return negative ? i64_limits::min() : i64_limits::max();
-                            }
-                            acc = (acc << 1) | static_cast<ull>(d);
-                        } else {
-                            break;
-                        }
-                    }
-                    int64_t result = static_cast<int64_t>(acc);
-                    return negative ? -result : result;
-                }
-            }
-
-            int base = 10;
-            std::string token(sv.begin(), sv.end());
-            if (token.size() >= 2) {
-                std::string p = token.substr(0, 2);
-                if (p == "0x" || p == "0X") {
-                    base = 16;
-                    token = token.substr(2);
-                } else if (p == "0o" || p == "0O") {
-                    base = 8;
-                    token = token.substr(2);
-                }
-            }
-
-            if (negative) token.insert(token.begin(), '-');
-
-            errno = 0;
-            char* endptr = nullptr;
-            long long parsed = std::strtoll(token.c_str(), &endptr, base);
-            if (endptr == token.c_str()) return 0;
-            if (errno == ERANGE) return (parsed > 0) ? i64_limits::max() : i64_limits::min();
-            if (parsed > i64_limits::max()) return i64_limits::max();
-            if (parsed < i64_limits::min()) return i64_limits::min();
-            return static_cast<int64_t>(parsed);
-        },
+        [](string_t s) -> int64_t { return detail::parse_int(std::string_view(s->c_str(), s->size())); },
         [](auto&&) -> int64_t { return 0; }
     );
 }
 
 inline double to_float(param_t value) noexcept {
+    if (value.is_boxed_int()) return static_cast<double>(value.as_int());
     return value.visit(
         [](null_t) -> double { return 0.0; },
         [](int_t i) -> double { return static_cast<double>(i); },
         [](float_t f) -> double { return f; },
         [](bool_t b) -> double { return b ? 1.0 : 0.0; },
-        [](string_t s) -> double {
-            std::string str = s->c_str();
-            for (auto& c : str) c = static_cast<char>(std::tolower(static_cast<unsigned char>(c)));
-
-            if (str == "nan") return std::numeric_limits<double>::quiet_NaN();
-            if (str == "infinity" || str == "+infinity" || str == "inf" || str == "+inf")
-                return std::numeric_limits<double>::infinity();
-            if (str == "-infinity" || str == "-inf")
-                return -std::numeric_limits<double>::infinity();
-            const char* cs = str.c_str();
-            errno = 0;
-            char* endptr = nullptr;
-            double val = std::strtod(cs, &endptr);
-            if (cs == endptr) return 0.0;
-            if (errno == ERANGE) return (val > 0) ? std::numeric_limits<double>::infinity()
-                                                 : -std::numeric_limits<double>::infinity();
-            return val;
-        },
+        [](string_t s) -> double { return detail::parse_float(std::string_view(s->c_str(), s->size())); },
         [](auto&&) -> double { return 0.0; }
     );
 }
@@ -205,6 +245,11 @@ inline std::string object_to_string(object_t obj) noexcept {
         case ObjectType::UPVALUE:
             return "<upvalue>";
 
+        case ObjectType::BOXED_INT: {
+            number_buffer_t buffer;
+            return std::string(format_int(buffer, reinterpret_cast<boxed_int_t>(obj)->get()));
+        }
+
         default:
             return "<unknown_object_type>";
     }
@@ -214,27 +259,13 @@ inline std::string object_to_string(object_t obj) noexcept {
 inline std::string to_string(param_t value) noexcept {
     return value.visit(
         [](null_t) -> std::string { return "null"; },
-        [](int_t val) -> std::string { return std::to_string(val); },
+        [](int_t val) -> std::string {
+            number_buffer_t buffer;
+            return std::string(format_int(buffer, val));
+        },
         [](float_t val) -> std::string {
-            if (std::isnan(val)) return "NaN";
-            if (std::isinf(val)) return (val > 0) ? "Infinity" : "-Infinity";
-
-            if (val == 0.0 && std::signbit(val)) return "-0.0";
-            
-            std::string str = std::format("{}", val);
-            
-            auto pos = str.find('.');
-            if (pos != std::string::npos) {
-                size_t end = str.size();
-                while (end > pos + 1 && str[end - 1] == '0') {
-                    --end;
-                }
-                if (end == pos + 1) {
-                    end++; 
-                }
-                return str.substr(0, end);
-            }
-            return str;
+            number_buffer_t buffer;
+            return std::string(format_float(buffer, val));
         },
         [](bool_t val) -> std::string { return val ? "true" : "false"; },
         [](native_t) -> std::string { return "<native_fn>"; },
@@ -2,6 +2,19 @@
 
 #include "common/pch.h"
 
+// Kiểm tra invariant nội bộ, chỉ có trong bản debug (NDEBUG thì không sinh ra code nào)
+#if !defined(NDEBUG)
+#define MEOW_ASSERT(condition) \
+    do { \
+        if (!(condition)) [[unlikely]] { \
+            std::cerr << __FILE__ << ":" << __LINE__ << ": MEOW_ASSERT(" #condition ") failed\n"; \
+            std::abort(); \
+        } \
+    } while (0)
+#else
+#define MEOW_ASSERT(condition) ((void)0)
+#endif
+
 namespace meow {
 }
 
@@ -21,6 +34,7 @@ class ObjFunctionProto;
 class ObjNativeFunction;
 class ObjClosure;
 class ObjModule;
+class ObjBoxedInt;
 
 
 using value_t = Value;
@@ -46,6 +60,7 @@ using upvalue_t = ObjUpvalue*;
 using proto_t = ObjFunctionProto*;
 using function_t = ObjClosure*;
 using module_t = ObjModule*;
+using boxed_int_t = ObjBoxedInt*;
 
 enum class ValueType : uint8_t {
     Null,
@@ -65,6 +80,7 @@ enum class ValueType : uint8_t {
     Proto,        // 8  — PROTO
     Function,     // 9  — FUNCTION
     Module,       // 10 — MODULE
+    BoxedInt,     // 11 — BOXED_INT (bảng toán tử coi như Int, xem get_value_type)
 
     TotalValueTypes
 };
@@ -19,6 +19,7 @@
 #include <algorithm>
 #include <bit>
 #include <cctype>
+#include <charconv>
 #include <cmath>
 #include <concepts>
 #include <cstdint>
@@ -13,10 +13,12 @@ enum class ObjectType : uint8_t {
     UPVALUE,
     PROTO,
     FUNCTION,
-    MODULE
+    MODULE,
+    BOXED_INT
 };
 
-struct MeowObject {
+// Căn lề 16 để Value gắn được loại object vào 4 bit thấp của con trỏ (xem core/value.h)
+struct alignas(16) MeowObject {
     const ObjectType type;
 
     explicit MeowObject(ObjectType type_tag) noexcept : type(type_tag) {}
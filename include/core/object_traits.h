@@ -43,6 +43,9 @@ template <> struct object_traits<ObjClosure> {
 template <> struct object_traits<ObjModule> {
     static constexpr ObjectType type_tag = ObjectType::MODULE;
 };
+template <> struct object_traits<ObjBoxedInt> {
+    static constexpr ObjectType type_tag = ObjectType::BOXED_INT;
+};
 
 }
 }
\ No newline at end of file
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "core/objects/array.h"
+#include "core/objects/boxed_int.h"
 #include "core/objects/function.h"
 #include "core/objects/hash_table.h"
 #include "core/objects/module.h"
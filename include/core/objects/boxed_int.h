@@ -0,0 +1,37 @@
+/**
+ * @file boxed_int.h
+ * @author LazyPaws
+ * @brief Heap-allocated 64-bit integer in TrangMeo
+ * @copyright Copyright (c) 2025 LazyPaws
+ * @license All rights reserved. Unauthorized copying of this file, in any form
+ * or medium, is strictly prohibited
+ */
+
+#pragma once
+
+#include "common/pch.h"
+#include "common/definitions.h"
+#include "core/meow_object.h"
+
+namespace meow {
+// Số nguyên không vừa small int của Value (payload NaN-box) thì được box lên heap. Bất biến,
+// và chỉ được tạo khi giá trị thật sự nằm ngoài khoảng small int (xem MemoryManager::new_int)
+class ObjBoxedInt : public ObjBase<ObjectType::BOXED_INT> {
+private:
+    using visitor_t = GCVisitor;
+    int_t value_;
+public:
+    explicit ObjBoxedInt(int_t value) noexcept : value_(value) {}
+
+    // --- Rule of 5 ---
+    ObjBoxedInt(const ObjBoxedInt&) = delete;
+    ObjBoxedInt(ObjBoxedInt&&) = delete;
+    ObjBoxedInt& operator=(const ObjBoxedInt&) = delete;
+    ObjBoxedInt& operator=(ObjBoxedInt&&) = delete;
+    ~ObjBoxedInt() override = default;
+
+    inline int_t get() const noexcept { return value_; }
+
+    inline void trace(visitor_t&) const noexcept override {}
+};
+}
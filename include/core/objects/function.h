@@ -33,6 +33,7 @@ class ObjUpvalue : public ObjBase<ObjectType::UPVALUE> {
     State state_ = State::OPEN;
     size_t index_ = 0;
     Value closed_ = null_t{};
+    upvalue_t next_open_ = nullptr; // Danh sách upvalue đang mở của ExecutionContext (intrusive)
 
    public:
     explicit ObjUpvalue(size_t index = 0) noexcept : index_(index) {
@@ -50,6 +51,12 @@ class ObjUpvalue : public ObjBase<ObjectType::UPVALUE> {
     inline size_t get_index() const noexcept {
         return index_;
     }
+    inline upvalue_t get_next_open() const noexcept {
+        return next_open_;
+    }
+    inline void set_next_open(upvalue_t next) noexcept {
+        next_open_ = next;
+    }
 
     void trace(visitor_t& visitor) const noexcept override;
 };
@@ -65,6 +72,7 @@ class ObjFunctionProto : public ObjBase<ObjectType::PROTO> {
     string_t name_;
     chunk_t chunk_;
     std::vector<UpvalueDesc> upvalue_descs_;
+    module_t module_ = nullptr; // Module định nghĩa hàm này: slot global trong chunk thuộc về bảng global của nó
 
    public:
     explicit ObjFunctionProto(size_t registers, size_t upvalues, string_t name, chunk_t&& chunk) noexcept : num_registers_(registers), num_upvalues_(upvalues), name_(name), chunk_(std::move(chunk)) {
@@ -93,6 +101,12 @@ class ObjFunctionProto : public ObjBase<ObjectType::PROTO> {
     inline const chunk_t& get_chunk() const noexcept {
         return chunk_;
     }
+    inline module_t get_module() const noexcept {
+        return module_;
+    }
+    inline void set_module(module_t module) noexcept {
+        module_ = module;
+    }
     inline size_t desc_size() const noexcept {
         return upvalue_descs_.size();
     }
@@ -14,6 +14,7 @@
 #include "core/meow_object.h"
 #include "common/definitions.h"
 #include "core/value.h"
+#include "core/symbol_map.h"
 #include "memory/gc_visitor.h"
 
 namespace meow {
@@ -21,51 +22,132 @@ class ObjModule : public ObjBase<ObjectType::MODULE> {
 private:
     using string_t = string_t;
     using proto_t = proto_t;
-    using module_map = std::unordered_map<string_t, value_t>;
     using visitor_t = GCVisitor;
 
-    enum class State { EXECUTING, EXECUTED };
+    enum class State { NOT_EXECUTED, EXECUTING, EXECUTED };
 
-    module_map globals_;
-    module_map exports_;
+    // Global được đánh chỉ số lúc load: GET_GLOBAL / SET_GLOBAL truy cập thẳng global_slots_[slot].
+    // Bảng tên chỉ dùng cho IMPORT_ALL, native module và debug.
+    std::vector<value_t> global_slots_;
+    std::vector<string_t> global_names_;
+    SymbolMap<uint32_t> global_index_;
+    // Export nằm trong export_slots_ của module sở hữu nó. Slot được cấp ở lần EXPORT đầu tiên và
+    // không bao giờ dời, nên GET_EXPORT resolve (owner, slot) một lần rồi đọc thẳng.
+    // IMPORT_ALL chỉ chép binding, export của module nguồn được dùng chung theo tham chiếu.
+    struct ExportBinding {
+        module_t owner_;
+        uint32_t slot_;
+    };
+    std::vector<value_t> export_slots_;
+    SymbolMap<ExportBinding> export_bindings_;
+    uint32_t export_epoch_ = 0; // tăng mỗi khi một tên đã có bị bind sang chỗ khác
     string_t file_name_;
     string_t file_path_;
     proto_t main_proto_;
 
-    State state;
+    State state = State::NOT_EXECUTED;
 
 public:
     explicit ObjModule(string_t file_name, string_t file_path, proto_t main_proto = nullptr) noexcept : file_name_(file_name), file_path_(file_path), main_proto_(main_proto) {}
 
-    // --- Globals ---
-    inline return_t get_global(string_t name) noexcept {
-        return globals_[name];
+    // --- Globals (theo slot) ---
+    static constexpr uint32_t NO_GLOBAL = std::numeric_limits<uint32_t>::max();
+
+    /// @brief Unchecked slot access. Slot đã được BinaryLoader kiểm tra nằm trong bảng
+    inline return_t get_global_slot(uint32_t slot) const noexcept {
+        return global_slots_[slot];
+    }
+    inline void set_global_slot(uint32_t slot, param_t value) noexcept {
+        global_slots_[slot] = value;
     }
-    inline void set_global(string_t name, param_t value) noexcept {
-        globals_[name] = value;
+    inline size_t global_count() const noexcept {
+        return global_slots_.size();
     }
-    inline bool has_global(string_t name) {
-        return globals_.contains(name);
+    inline string_t get_global_name(uint32_t slot) const noexcept {
+        return global_names_[slot];
     }
-    inline void import_all_global(const module_t other) noexcept {
-        for (const auto& [key, value] : other->globals_) {
-            globals_[key] = value;
+
+    // Khai báo bảng tên global của module (thứ tự = slot), mọi slot bắt đầu là null
+    inline void define_globals(std::vector<string_t>&& names) {
+        global_names_ = std::move(names);
+        global_slots_.assign(global_names_.size(), value_t(null_t{}));
+        global_index_.clear();
+        global_index_.reserve(global_names_.size());
+        for (uint32_t slot = 0; slot < global_names_.size(); ++slot) {
+            global_index_.try_emplace(global_names_[slot], slot);
+        }
+    }
+    inline uint32_t find_global(string_t name) const noexcept {
+        const uint32_t* slot = global_index_.find(name);
+        return slot ? *slot : NO_GLOBAL;
+    }
+    // Slot của global `name`, thêm slot mới nếu chưa có
+    inline uint32_t add_global(string_t name) {
+        if (uint32_t slot = find_global(name); slot != NO_GLOBAL) return slot;
+        uint32_t slot = static_cast<uint32_t>(global_slots_.size());
+        global_names_.push_back(name);
+        global_slots_.emplace_back(null_t{});
+        global_index_.try_emplace(name, slot);
+        return slot;
+    }
+
+    // --- Globals (theo tên) ---
+    inline return_t get_global(string_t name) const noexcept {
+        uint32_t slot = find_global(name);
+        return slot != NO_GLOBAL ? global_slots_[slot] : value_t(null_t{});
+    }
+    inline void set_global(string_t name, param_t value) {
+        global_slots_[add_global(name)] = value;
+    }
+    inline bool has_global(string_t name) const noexcept {
+        return find_global(name) != NO_GLOBAL;
+    }
+    inline void import_all_global(const module_t other) {
+        for (uint32_t slot = 0; slot < other->global_names_.size(); ++slot) {
+            set_global(other->global_names_[slot], other->global_slots_[slot]);
         }
     }
 
     // --- Exports ---
-    inline return_t get_export(string_t name) noexcept {
-        return exports_[name];
+    inline const ExportBinding* find_export(string_t name) const noexcept {
+        return export_bindings_.find(name);
     }
-    inline void set_export(string_t name, param_t value) noexcept {
-        exports_[name] = value;
+    /// @brief Unchecked slot access. Slot lấy từ find_export của chính module này hoặc module re-export nó
+    inline return_t get_export_slot(uint32_t slot) const noexcept {
+        return export_slots_[slot];
     }
-    inline bool has_export(string_t name) {
-        return exports_.contains(name);
+    inline uint32_t get_export_epoch() const noexcept {
+        return export_epoch_;
     }
-    inline void import_all_export(const module_t other) noexcept {
-        for (const auto& [key, value] : other->exports_) {
-            exports_[key] = value;
+
+    inline return_t get_export(string_t name) const noexcept {
+        const ExportBinding* binding = find_export(name);
+        return binding ? binding->owner_->export_slots_[binding->slot_] : value_t(null_t{});
+    }
+    inline void set_export(string_t name, param_t value) {
+        auto [found, inserted] = export_bindings_.try_emplace(name, ExportBinding{this, 0});
+        ExportBinding& binding = *found;
+        if (!inserted && binding.owner_ == this) {
+            export_slots_[binding.slot_] = value;
+            return;
+        }
+        // Tên mới, hoặc tên đang trỏ sang module khác (từ IMPORT_ALL) giờ do module này sở hữu
+        if (!inserted) ++export_epoch_;
+        binding = ExportBinding{this, static_cast<uint32_t>(export_slots_.size())};
+        export_slots_.push_back(value);
+    }
+    inline bool has_export(string_t name) const noexcept {
+        return export_bindings_.contains(name);
+    }
+    inline void import_all_export(const module_t other) {
+        for (const auto& [name, source] : other->export_bindings_) {
+            auto [found, inserted] = export_bindings_.try_emplace(name, source);
+            if (inserted) continue;
+            ExportBinding& binding = *found;
+            if (binding.owner_ != source.owner_ || binding.slot_ != source.slot_) {
+                binding = source;
+                ++export_epoch_;
+            }
         }
     }
 
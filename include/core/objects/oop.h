@@ -14,6 +14,9 @@
 #include "core/meow_object.h"
 #include "common/definitions.h"
 #include "core/value.h"
+#include "core/objects/shape.h"
+#include "core/objects/string.h"
+#include "core/symbol_map.h"
 #include "memory/gc_visitor.h"
 
 namespace meow {
@@ -21,15 +24,39 @@ class ObjClass : public ObjBase<ObjectType::CLASS> {
    private:
     using string_t = string_t;
     using class_t = class_t;
-    using method_map = std::unordered_map<string_t, value_t>;
+    using method_map = SymbolMap<value_t>;
     using visitor_t = GCVisitor;
 
     string_t name_;
     class_t superclass_;
-    method_map methods_;
+    method_map methods_; // Method khai báo trực tiếp trên class này
+    std::unique_ptr<Shape> root_shape_;
+
+    // Bảng method đã làm phẳng (kế thừa + của riêng class, method con đè method cha) để tra cứu
+    // không phụ thuộc độ sâu cây kế thừa. Bảng được dựng lại lười: mỗi lần SET_METHOD / INHERIT
+    // tăng hierarchy_epoch_, lần tra cứu sau mới kiểm tra xem chuỗi cha có thật sự đổi không.
+    // Không cần trace: mọi giá trị trong bảng đều nằm trong methods_ của class này hoặc class cha.
+    method_map method_table_;
+    uint64_t modified_at_ = 0;  // hierarchy_epoch_ lúc methods_ / superclass_ của class này đổi lần cuối
+    uint64_t chain_stamp_ = 0;  // modified_at_ lớn nhất trong chuỗi cha lúc dựng method_table_
+    uint64_t table_epoch_ = 0;  // hierarchy_epoch_ lúc method_table_ được kiểm tra lần cuối
+    uint32_t version_ = 0;      // Tăng mỗi khi method_table_ đổi nội dung, dùng để guard inline cache
+
+    static inline uint64_t hierarchy_epoch_ = 1;
+
+    // Constructor fast path: method "init" của chính class (null nếu không có), được cập nhật ngay trong
+    // set_method nên CALL không phải intern chuỗi "init" rồi tra bảng ở mỗi lần tạo object
+    value_t initializer_;
+    // Số field lớn nhất quan sát được sau khi init chạy xong, dùng để cấp phát trước slot cho instance mới
+    uint32_t expected_field_count_ = 0;
+
+    void rebuild_method_table();
+    inline void refresh_method_table() {
+        if (table_epoch_ != hierarchy_epoch_) [[unlikely]] rebuild_method_table();
+    }
 
    public:
-    explicit ObjClass(string_t name = nullptr) noexcept : name_(name) {
+    explicit ObjClass(string_t name = nullptr) : name_(name), root_shape_(std::make_unique<Shape>()) {
     }
 
     // --- Metadata ---
@@ -41,17 +68,59 @@ class ObjClass : public ObjBase<ObjectType::CLASS> {
     }
     inline void set_super(class_t super) noexcept {
         superclass_ = super;
+        modified_at_ = ++hierarchy_epoch_;
+    }
+    // true nếu `ancestor` là chính class này hoặc một class cha của nó
+    inline bool inherits_from(const ObjClass* ancestor) const noexcept {
+        for (const ObjClass* k = this; k; k = k->superclass_) {
+            if (k == ancestor) return true;
+        }
+        return false;
     }
 
     // --- Methods ---
     inline bool has_method(string_t name) const noexcept {
-        return methods_.find(name) != methods_.end();
+        return methods_.contains(name);
     }
-    inline return_t get_method(string_t name) noexcept {
-        return methods_[name];
+    inline return_t get_method(string_t name) const noexcept {
+        const value_t* method = methods_.find(name);
+        return method ? *method : value_t(null_t{});
     }
-    inline void set_method(string_t name, return_t value) noexcept {
+    inline void set_method(string_t name, return_t value) {
         methods_[name] = value;
+        modified_at_ = ++hierarchy_epoch_;
+        if (std::string_view(name->c_str(), name->size()) == "init") {
+            initializer_ = value;
+        }
+    }
+
+    // Tra method kể cả kế thừa, O(1) theo độ sâu cây kế thừa. nullptr nếu không có.
+    inline const value_t* find_method(string_t name) {
+        refresh_method_table();
+        return method_table_.find(name);
+    }
+    inline uint32_t get_method_version() {
+        refresh_method_table();
+        return version_;
+    }
+
+    // --- Construction ---
+    inline return_t get_initializer() const noexcept {
+        return initializer_;
+    }
+    inline uint32_t get_expected_field_count() const noexcept {
+        return expected_field_count_;
+    }
+    inline void record_field_count(uint32_t count) noexcept {
+        if (count > expected_field_count_) {
+            expected_field_count_ = std::min(count, Shape::MAX_FIELDS);
+        }
+    }
+
+    // --- Shapes ---
+    // Shape rỗng mà mọi instance mới của class bắt đầu từ đó
+    inline Shape* get_root_shape() const noexcept {
+        return root_shape_.get();
     }
 
     void trace(visitor_t& visitor) const noexcept override;
@@ -61,14 +130,36 @@ class ObjInstance : public ObjBase<ObjectType::INSTANCE> {
    private:
     using string_t = string_t;
     using class_t = class_t;
-    using field_map = std::unordered_map<string_t, value_t>;
+    using field_map = SymbolMap<value_t>;
     using visitor_t = GCVisitor;
 
+    // Fast mode: shape_ cho biết field nào nằm ở slot nào, giá trị nằm liền nhau trong slots_.
+    // Dictionary mode (shape_ == nullptr): instance có quá nhiều field hoặc class sinh quá nhiều
+    // nhánh shape, khi đó field được giữ trong bảng băm riêng như trước.
     class_t klass_;
-    field_map fields_;
+    Shape* shape_;
+    std::vector<value_t> slots_;
+    std::unique_ptr<field_map> dictionary_;
+
+    inline void convert_to_dictionary() {
+        auto dictionary = std::make_unique<field_map>();
+        dictionary->reserve(slots_.size() + 1);
+        for (uint32_t slot = 0; slot < slots_.size(); ++slot) {
+            dictionary->try_emplace(shape_->key_at(slot), slots_[slot]);
+        }
+        dictionary_ = std::move(dictionary);
+        shape_ = nullptr;
+        slots_.clear();
+        slots_.shrink_to_fit();
+    }
 
    public:
-    explicit ObjInstance(class_t k = nullptr) noexcept : klass_(k) {
+    explicit ObjInstance(class_t k = nullptr) : klass_(k), shape_(k ? k->get_root_shape() : nullptr) {
+        if (shape_) {
+            slots_.reserve(k->get_expected_field_count());
+        } else {
+            dictionary_ = std::make_unique<field_map>();
+        }
     }
 
     // --- Metadata ---
@@ -79,15 +170,60 @@ class ObjInstance : public ObjBase<ObjectType::INSTANCE> {
         klass_ = klass;
     }
 
+    // --- Shape ---
+    inline Shape* get_shape() const noexcept {
+        return shape_;
+    }
+    inline bool is_dictionary() const noexcept {
+        return shape_ == nullptr;
+    }
+    inline uint32_t field_count() const noexcept {
+        return static_cast<uint32_t>(shape_ ? slots_.size() : dictionary_->size());
+    }
+
+    // Truy cập trực tiếp theo slot, chỉ hợp lệ khi caller đã kiểm tra shape
+    inline return_t get_slot(uint32_t slot) const noexcept {
+        return slots_[slot];
+    }
+    inline void set_slot(uint32_t slot, param_t value) noexcept {
+        slots_[slot] = value;
+    }
+    // Thêm field theo transition đã biết trước (next phải là shape con của shape hiện tại)
+    inline void append_slot(Shape* next, param_t value) {
+        shape_ = next;
+        slots_.push_back(value);
+    }
+
     // --- Fields ---
-    inline return_t get_field(string_t name) noexcept {
-        return fields_[name];
+    // Một lần tra cứu duy nhất; nullptr nếu field chưa tồn tại
+    inline value_t* find_field(string_t name) noexcept {
+        if (shape_) {
+            uint32_t slot = shape_->find(name);
+            return slot != Shape::NOT_FOUND ? &slots_[slot] : nullptr;
+        }
+        return dictionary_->find(name);
     }
-    inline void set_field(string_t name, param_t value) noexcept {
-        fields_[name] = value;
+    inline return_t get_field(string_t name) noexcept {
+        value_t* field = find_field(name);
+        return field ? *field : value_t(null_t{});
+    }
+    inline void set_field(string_t name, param_t value) {
+        if (value_t* field = find_field(name)) {
+            *field = value;
+            return;
+        }
+        if (shape_) {
+            if (Shape* next = shape_->transition(name)) {
+                shape_ = next;
+                slots_.push_back(value);
+                return;
+            }
+            convert_to_dictionary();
+        }
+        (*dictionary_)[name] = value;
     }
     inline bool has_field(string_t name) const {
-        return fields_.find(name) != fields_.end();
+        return const_cast<ObjInstance*>(this)->find_field(name) != nullptr;
     }
 
     void trace(visitor_t& visitor) const noexcept override;
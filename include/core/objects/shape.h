@@ -0,0 +1,76 @@
+/**
+ * @file shape.h
+ * @author LazyPaws
+ * @brief Hidden class (Shape) describing the field layout of ObjInstance in TrangMeo
+ * @copyright Copyright (c) 2025 LazyPaws
+ * @license All rights reserved. Unauthorized copying of this file, in any form
+ * or medium, is strictly prohibited
+ */
+
+#pragma once
+
+#include "common/pch.h"
+#include "common/definitions.h"
+#include "core/symbol_map.h"
+#include "memory/gc_visitor.h"
+
+namespace meow {
+// Shape mô tả thứ tự các field của một instance: field thứ i nằm ở slot i. Các instance thêm field
+// theo cùng thứ tự thì dùng chung shape, nên mỗi instance chỉ cần một mảng Value liền nhau.
+// Shape không phải GC object: cây shape thuộc về ObjClass (root shape) và sống cùng class đó.
+// Id tăng đơn điệu và không bao giờ được dùng lại, nên cache có thể so sánh id thay cho con trỏ.
+class Shape {
+   public:
+    static constexpr uint32_t NOT_FOUND = std::numeric_limits<uint32_t>::max();
+    // Quá số field / số nhánh này thì instance chuyển sang dictionary mode
+    static constexpr uint32_t MAX_FIELDS = 64;
+    static constexpr uint32_t MAX_TRANSITIONS = 32;
+
+    Shape() noexcept;
+    Shape(const Shape&) = delete;
+    Shape(Shape&&) = delete;
+    Shape& operator=(const Shape&) = delete;
+    Shape& operator=(Shape&&) = delete;
+    ~Shape() noexcept = default;
+
+    // --- Metadata ---
+    inline uint32_t get_id() const noexcept {
+        return id_;
+    }
+    inline uint32_t field_count() const noexcept {
+        return static_cast<uint32_t>(keys_.size());
+    }
+    inline string_t key_at(uint32_t slot) const noexcept {
+        return keys_[slot];
+    }
+
+    // --- Lookup ---
+    inline uint32_t find(string_t name) const noexcept {
+        if (index_.empty()) {
+            for (uint32_t slot = 0; slot < keys_.size(); ++slot) {
+                if (keys_[slot] == name) return slot;
+            }
+            return NOT_FOUND;
+        }
+        const uint32_t* slot = index_.find(name);
+        return slot ? *slot : NOT_FOUND;
+    }
+
+    // Shape con sau khi thêm field `name` (tạo mới nếu chưa có). nullptr khi vượt giới hạn.
+    Shape* transition(string_t name);
+
+    // Đánh dấu các tên field của cả cây shape con
+    void trace(GCVisitor& visitor) const noexcept;
+
+   private:
+    // Field ít thì quét tuyến tính keys_, nhiều hơn ngưỡng này mới dựng bảng băm
+    static constexpr uint32_t LINEAR_SCAN_LIMIT = 8;
+
+    uint32_t id_;
+    std::vector<string_t> keys_;
+    SymbolMap<uint32_t> index_;
+    SymbolMap<std::unique_ptr<Shape>> transitions_;
+
+    Shape(const Shape& parent, string_t name) noexcept;
+};
+}
@@ -15,12 +15,14 @@ private:
     using storage_t = std::string;
     using visitor_t = GCVisitor;
     storage_t data_;
+    uint64_t symbol_id_ = 0; // Cấp bởi MemoryManager lúc intern, 0 nghĩa là chưa intern
 public:
     // --- Constructors & destructor ---
     ObjString() = default;
     explicit ObjString(const storage_t& data) : data_(data) {}
     explicit ObjString(storage_t&& data) noexcept : data_(std::move(data)) {}
     explicit ObjString(const char* data) : data_(data) {}
+    ObjString(storage_t&& data, uint64_t symbol_id) noexcept : data_(std::move(data)), symbol_id_(symbol_id) {}
 
     // --- Rule of 5 ---
     ObjString(const ObjString&) = delete;
@@ -66,6 +68,10 @@ public:
     // --- String access ---
     inline const char* c_str() const noexcept { return data_.c_str(); }
 
+    // --- Symbol ---
+    // Id liên tục của chuỗi đã intern, dùng làm key của SymbolMap
+    inline uint64_t get_symbol() const noexcept { return symbol_id_; }
+
     // --- Capacity ---
     inline size_t size() const noexcept { return data_.size(); }
     inline bool empty() const noexcept { return data_.empty(); }
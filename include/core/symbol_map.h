@@ -0,0 +1,164 @@
+/**
+ * @file symbol_map.h
+ * @author LazyPaws
+ * @brief Open-addressing table keyed by interned name (symbol id) in TrangMeo
+ * @copyright Copyright (c) 2025 LazyPaws
+ * @license All rights reserved. Unauthorized copying of this file, in any form
+ * or medium, is strictly prohibited
+ */
+
+#pragma once
+
+#include "common/pch.h"
+#include "common/definitions.h"
+#include "core/objects/string.h"
+
+namespace meow {
+/**
+ * Bảng băm địa chỉ mở cho tên đã intern. Mỗi chuỗi intern có symbol id 64-bit riêng (cấp lúc intern,
+ * liên tục từ 1), nên việc dò chỉ so sánh số nguyên trên mảng ids_ liền nhau; entry (tên, giá trị)
+ * nằm ở mảng song song và chỉ bị đụng tới khi trúng. Không hỗ trợ xoá, các bảng dùng nó chỉ thêm.
+ */
+template <typename T>
+class SymbolMap {
+public:
+    struct Entry {
+        string_t key_ = nullptr;
+        T value_{};
+    };
+
+    SymbolMap() = default;
+
+    // --- Lookup ---
+    inline T* find(string_t key) noexcept {
+        size_t index = probe(key->get_symbol());
+        return index != NPOS ? &entries_[index].value_ : nullptr;
+    }
+    inline const T* find(string_t key) const noexcept {
+        size_t index = probe(key->get_symbol());
+        return index != NPOS ? &entries_[index].value_ : nullptr;
+    }
+    inline bool contains(string_t key) const noexcept {
+        return probe(key->get_symbol()) != NPOS;
+    }
+
+    // --- Modifiers ---
+    // Giống std::unordered_map::try_emplace: không đụng tới giá trị cũ nếu key đã có
+    template <typename... Args>
+    inline std::pair<T*, bool> try_emplace(string_t key, Args&&... args) {
+        uint64_t id = key->get_symbol();
+        if (size_t index = probe(id); index != NPOS) {
+            return {&entries_[index].value_, false};
+        }
+        if ((size_ + 1) * 4 > ids_.size() * 3) grow();
+        size_t index = slot_for(id);
+        ids_[index] = id;
+        entries_[index] = Entry{key, T(std::forward<Args>(args)...)};
+        ++size_;
+        return {&entries_[index].value_, true};
+    }
+    inline T& operator[](string_t key) {
+        return *try_emplace(key).first;
+    }
+    inline void reserve(size_t count) {
+        size_t capacity = MIN_CAPACITY;
+        while (count * 4 > capacity * 3) capacity <<= 1;
+        if (capacity > ids_.size()) rehash(capacity);
+    }
+    inline void clear() noexcept {
+        ids_.clear();
+        entries_.clear();
+        size_ = 0;
+    }
+
+    // --- Capacity ---
+    inline size_t size() const noexcept {
+        return size_;
+    }
+    inline bool empty() const noexcept {
+        return size_ == 0;
+    }
+
+    // --- Iterators (bỏ qua ô trống, thứ tự không xác định) ---
+    template <typename Map, typename Value>
+    class basic_iterator {
+    public:
+        basic_iterator(Map* map, size_t index) noexcept : map_(map), index_(index) {
+            skip_empty();
+        }
+        inline Value& operator*() const noexcept {
+            return map_->entries_[index_];
+        }
+        inline Value* operator->() const noexcept {
+            return &map_->entries_[index_];
+        }
+        inline basic_iterator& operator++() noexcept {
+            ++index_;
+            skip_empty();
+            return *this;
+        }
+        inline bool operator==(const basic_iterator& other) const noexcept {
+            return index_ == other.index_;
+        }
+    private:
+        Map* map_;
+        size_t index_;
+        inline void skip_empty() noexcept {
+            while (index_ < map_->ids_.size() && map_->ids_[index_] == EMPTY) ++index_;
+        }
+    };
+    using iterator = basic_iterator<SymbolMap, Entry>;
+    using const_iterator = basic_iterator<const SymbolMap, const Entry>;
+
+    inline iterator begin() noexcept { return iterator(this, 0); }
+    inline iterator end() noexcept { return iterator(this, ids_.size()); }
+    inline const_iterator begin() const noexcept { return const_iterator(this, 0); }
+    inline const_iterator end() const noexcept { return const_iterator(this, ids_.size()); }
+
+private:
+    static constexpr uint64_t EMPTY = 0; // Symbol id bắt đầu từ 1
+    static constexpr size_t NPOS = std::numeric_limits<size_t>::max();
+    static constexpr size_t MIN_CAPACITY = 8;
+
+    std::vector<uint64_t> ids_;
+    std::vector<Entry> entries_;
+    size_t size_ = 0;
+
+    // Fibonacci hashing: id liên tục vẫn được rải đều trên bảng
+    inline size_t home_of(uint64_t id) const noexcept {
+        return static_cast<size_t>((id * 0x9E3779B97F4A7C15ull) >> 32) & (ids_.size() - 1);
+    }
+
+    inline size_t probe(uint64_t id) const noexcept {
+        if (ids_.empty()) return NPOS;
+        size_t mask = ids_.size() - 1;
+        for (size_t index = home_of(id);; index = (index + 1) & mask) {
+            if (ids_[index] == id) return index;
+            if (ids_[index] == EMPTY) return NPOS;
+        }
+    }
+
+    // Ô trống đầu tiên trên đường dò của id (bảng luôn còn chỗ trống)
+    inline size_t slot_for(uint64_t id) const noexcept {
+        size_t mask = ids_.size() - 1;
+        size_t index = home_of(id);
+        while (ids_[index] != EMPTY) index = (index + 1) & mask;
+        return index;
+    }
+
+    inline void grow() {
+        rehash(ids_.empty() ? MIN_CAPACITY : ids_.size() * 2);
+    }
+
+    void rehash(size_t capacity) {
+        std::vector<uint64_t> old_ids = std::exchange(ids_, std::vector<uint64_t>(capacity, EMPTY));
+        std::vector<Entry> old_entries = std::exchange(entries_, std::vector<Entry>(capacity));
+        for (size_t i = 0; i < old_ids.size(); ++i) {
+            if (old_ids[i] == EMPTY) continue;
+            size_t index = slot_for(old_ids[i]);
+            ids_[index] = old_ids[i];
+            entries_[index] = std::move(old_entries[i]);
+        }
+    }
+};
+}
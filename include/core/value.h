@@ -5,6 +5,24 @@
 #include "meow_variant.h"
 #include "core/meow_object.h"
 #include "core/object_traits.h"
+#include "core/objects/boxed_int.h"
+
+namespace meow {
+// Subtag của một ObjectType: 1..12, 0 để dành cho con trỏ null
+inline constexpr uint64_t object_subtag(ObjectType type) noexcept {
+    return static_cast<uint64_t>(type) - (static_cast<uint64_t>(ObjectType::ARRAY) - 1);
+}
+}
+
+// Loại object được gắn vào 4 bit thấp của con trỏ (MeowObject căn lề 16), nên is_string(), is_array()...
+// chỉ là một phép mask + so sánh trên bit của Value, không phải đọc object
+template <>
+struct meow::utils::pointer_subtag_traits<meow::object_t> {
+    static constexpr unsigned bits = 4;
+    static uint64_t of(meow::object_t object) noexcept {
+        return object ? meow::object_subtag(object->get_type()) : 0;
+    }
+};
 
 namespace meow {
 
@@ -14,21 +32,35 @@ class Value {
 private:
     base_t data_;
 
-    template <typename Self>
-    inline auto get_object_ptr(this Self&& self) noexcept {
-        if (auto obj_ptr = self.data_.template get_if<object_t>()) {
-            return *obj_ptr;
-        }
-        using ret_t = std::remove_reference_t<decltype(*std::declval<object_t*>())>;
-        return static_cast<ret_t>(nullptr);
+    // Không public: int_t nào cũng chuyển ngầm được sang đây, dễ lọt số vượt 48 bit mà bản release
+    // không kiểm tra. Tạo small int qua Value::small_int, số bất kỳ qua MemoryManager::new_int
+    inline Value(int_t v) noexcept : data_(v) { MEOW_ASSERT(fits_small_int(v)); }
+
+    inline bool is_object_of(ObjectType type) const noexcept {
+        return data_.template holds_subtag<object_t>(object_subtag(type));
     }
 
 public:
+    // --- Small int ---
+    // Số nguyên nằm thẳng trong Value chỉ có integer_bits bit (48 với NaN-box). Số ngoài khoảng đó
+    // phải đi qua MemoryManager::new_int để được box thành ObjBoxedInt; Value::small_int thì không cấp phát.
+    static constexpr unsigned SMALL_INT_BITS = base_t::integer_bits;
+    static constexpr int_t SMALL_INT_MIN = static_cast<int_t>(~uint64_t{0} << (SMALL_INT_BITS - 1));
+    static constexpr int_t SMALL_INT_MAX = ~SMALL_INT_MIN;
+
+    static constexpr bool fits_small_int(int_t v) noexcept {
+        return v >= SMALL_INT_MIN && v <= SMALL_INT_MAX;
+    }
+
+    // v phải vừa small int (số có thể lớn hơn thì dùng MemoryManager::new_int); bản release không kiểm tra
+    static inline Value small_int(int_t v) noexcept {
+        return Value(v);
+    }
+
     // --- Constructors ---
     inline Value() noexcept : data_(null_t{}) {}
     inline Value(null_t v) noexcept : data_(std::move(v)) {}
     inline Value(bool_t v) noexcept : data_(v) {}
-    inline Value(int_t v) noexcept : data_(v) {}
     inline Value(float_t v) noexcept : data_(v) {}
     inline Value(object_t v) noexcept : data_(v) {}
 
@@ -51,7 +83,7 @@ public:
     // --- Assignment operators ---
     inline Value& operator=(null_t v) noexcept { data_ = std::move(v); return *this; }
     inline Value& operator=(bool_t v) noexcept { data_ = v; return *this; }
-    inline Value& operator=(int_t v) noexcept { data_ = v; return *this; }
+    Value& operator=(int_t v) = delete; // Value::small_int hoặc MemoryManager::new_int
     inline Value& operator=(float_t v) noexcept { data_ = v; return *this; }
     inline Value& operator=(object_t v) noexcept { data_ = v; return *this; }
 
@@ -64,60 +96,63 @@ public:
     // --- Primary type ---
     inline bool is_null() const noexcept { return data_.holds<null_t>(); }
     inline bool is_bool() const noexcept { return data_.holds<bool_t>(); }
-    inline bool is_int() const noexcept { return data_.holds<int_t>(); }
+    // Int gồm cả small int lẫn int đã box; code nóng nên guard bằng is_small_int() (một phép so mask)
+    inline bool is_int() const noexcept { return is_small_int() || is_boxed_int(); }
+    inline bool is_small_int() const noexcept { return data_.holds<int_t>(); }
     inline bool is_float() const noexcept { return data_.holds<float_t>(); }
     inline bool is_native() const noexcept { return data_.holds<native_t>(); }
 
     // --- Object type (generic) ---
     inline bool is_object() const noexcept {
-        return get_object_ptr() != nullptr;
+        return data_.template holds<object_t>() && data_.template subtag<object_t>() != 0;
+    }
+    // Chỉ hợp lệ khi is_object()
+    inline ObjectType object_type() const noexcept {
+        return static_cast<ObjectType>(data_.template subtag<object_t>() + (static_cast<uint64_t>(ObjectType::ARRAY) - 1));
     }
 
     // --- Specific object type ---
     inline bool is_array() const noexcept {
-        auto obj = get_object_ptr();
-        return (obj && obj->get_type() == ObjectType::ARRAY);
+        return is_object_of(ObjectType::ARRAY);
     }
     inline bool is_string() const noexcept {
-        auto obj = get_object_ptr();
-        return (obj && obj->get_type() == ObjectType::STRING);
+        return is_object_of(ObjectType::STRING);
     }
     inline bool is_hash_table() const noexcept {
-        auto obj = get_object_ptr();
-        return (obj && obj->get_type() == ObjectType::HASH_TABLE);
+        return is_object_of(ObjectType::HASH_TABLE);
     }
     inline bool is_upvalue() const noexcept {
-        auto obj = get_object_ptr();
-        return (obj && obj->get_type() == ObjectType::UPVALUE);
+        return is_object_of(ObjectType::UPVALUE);
     }
     inline bool is_proto() const noexcept {
-        auto obj = get_object_ptr();
-        return (obj && obj->get_type() == ObjectType::PROTO);
+        return is_object_of(ObjectType::PROTO);
     }
     inline bool is_function() const noexcept {
-        auto obj = get_object_ptr();
-        return (obj && obj->get_type() == ObjectType::FUNCTION);
+        return is_object_of(ObjectType::FUNCTION);
     }
     inline bool is_class() const noexcept {
-        auto obj = get_object_ptr();
-        return (obj && obj->get_type() == ObjectType::CLASS);
+        return is_object_of(ObjectType::CLASS);
     }
     inline bool is_instance() const noexcept {
-        auto obj = get_object_ptr();
-        return (obj && obj->get_type() == ObjectType::INSTANCE);
+        return is_object_of(ObjectType::INSTANCE);
     }
     inline bool is_bound_method() const noexcept {
-        auto obj = get_object_ptr();
-        return (obj && obj->get_type() == ObjectType::BOUND_METHOD);
+        return is_object_of(ObjectType::BOUND_METHOD);
     }
     inline bool is_module() const noexcept {
-        auto obj = get_object_ptr();
-        return (obj && obj->get_type() == ObjectType::MODULE);
+        return is_object_of(ObjectType::MODULE);
+    }
+    inline bool is_boxed_int() const noexcept {
+        return is_object_of(ObjectType::BOXED_INT);
     }
 
     // === Accessors (Unsafe / By Value) ===
     inline bool as_bool() const noexcept { return data_.get<bool_t>(); }
-    inline int64_t as_int() const noexcept { return data_.get<int_t>(); }
+    inline int64_t as_int() const noexcept {
+        if (is_small_int()) [[likely]] return as_small_int();
+        return as_boxed_int()->get();
+    }
+    inline int64_t as_small_int() const noexcept { return data_.get<int_t>(); }
     inline double as_float() const noexcept { return data_.get<float_t>(); }
     inline native_t as_native() const noexcept { return data_.get<native_t>(); }
     
@@ -154,6 +189,9 @@ public:
     inline module_t as_module() const noexcept {
         return reinterpret_cast<module_t>(as_object());
     }
+    inline boxed_int_t as_boxed_int() const noexcept {
+        return reinterpret_cast<boxed_int_t>(as_object());
+    }
 
     // === Safe Getters (Deducing 'this' - C++23) ===
     
@@ -163,6 +201,7 @@ public:
         return self.data_.template get_if<bool_t>();
     }
 
+    // Chỉ small int (int đã box không có địa chỉ int_t để trỏ tới)
     template <typename Self>
     inline auto as_if_int(this Self&& self) noexcept {
         return self.data_.template get_if<int_t>();
@@ -183,111 +222,61 @@ public:
     // Array
     template <typename Self>
     inline auto as_if_array(this Self&& self) noexcept {
-        if (auto obj = self.get_object_ptr()) {
-            if (obj->get_type() == ObjectType::ARRAY) {
-                return reinterpret_cast<array_t>(obj);
-            }
-        }
-        return static_cast<array_t>(nullptr);
+        return self.is_array() ? self.as_array() : static_cast<array_t>(nullptr);
     }
 
     // String
     template <typename Self>
     inline auto as_if_string(this Self&& self) noexcept {
-        if (auto obj = self.get_object_ptr()) {
-            if (obj->get_type() == ObjectType::STRING) {
-                return reinterpret_cast<string_t>(obj);
-            }
-        }
-        return static_cast<string_t>(nullptr);
+        return self.is_string() ? self.as_string() : static_cast<string_t>(nullptr);
     }
 
     // Hash table
     template <typename Self>
     inline auto as_if_hash_table(this Self&& self) noexcept {
-        if (auto obj = self.get_object_ptr()) {
-            if (obj->get_type() == ObjectType::HASH_TABLE) {
-                return reinterpret_cast<hash_table_t>(obj);
-            }
-        }
-        return static_cast<hash_table_t>(nullptr);
+        return self.is_hash_table() ? self.as_hash_table() : static_cast<hash_table_t>(nullptr);
     }
 
     // Upvalue
     template <typename Self>
     inline auto as_if_upvalue(this Self&& self) noexcept {
-        if (auto obj = self.get_object_ptr()) {
-            if (obj->get_type() == ObjectType::UPVALUE) {
-                return reinterpret_cast<upvalue_t>(obj);
-            }
-        }
-        return static_cast<upvalue_t>(nullptr);
+        return self.is_upvalue() ? self.as_upvalue() : static_cast<upvalue_t>(nullptr);
     }
 
     // Proto
     template <typename Self>
     inline auto as_if_proto(this Self&& self) noexcept {
-        if (auto obj = self.get_object_ptr()) {
-            if (obj->get_type() == ObjectType::PROTO) {
-                return reinterpret_cast<proto_t>(obj);
-            }
-        }
-        return static_cast<proto_t>(nullptr);
+        return self.is_proto() ? self.as_proto() : static_cast<proto_t>(nullptr);
     }
 
     // Function
     template <typename Self>
     inline auto as_if_function(this Self&& self) noexcept {
-        if (auto obj = self.get_object_ptr()) {
-            if (obj->get_type() == ObjectType::FUNCTION) {
-                return reinterpret_cast<function_t>(obj);
-            }
-        }
-        return static_cast<function_t>(nullptr);
+        return self.is_function() ? self.as_function() : static_cast<function_t>(nullptr);
     }
 
     // Class
     template <typename Self>
     inline auto as_if_class(this Self&& self) noexcept {
-        if (auto obj = self.get_object_ptr()) {
-            if (obj->get_type() == ObjectType::CLASS) {
-                return reinterpret_cast<class_t>(obj);
-            }
-        }
-        return static_cast<class_t>(nullptr);
+        return self.is_class() ? self.as_class() : static_cast<class_t>(nullptr);
     }
 
     // Instance
     template <typename Self>
     inline auto as_if_instance(this Self&& self) noexcept {
-        if (auto obj = self.get_object_ptr()) {
-            if (obj->get_type() == ObjectType::INSTANCE) {
-                return reinterpret_cast<instance_t>(obj);
-            }
-        }
-        return static_cast<instance_t>(nullptr);
+        return self.is_instance() ? self.as_instance() : static_cast<instance_t>(nullptr);
     }
 
     // Bound method
     template <typename Self>
     inline auto as_if_bound_method(this Self&& self) noexcept {
-        if (auto obj = self.get_object_ptr()) {
-            if (obj->get_type() == ObjectType::BOUND_METHOD) {
-                return reinterpret_cast<bound_method_t>(obj);
-            }
-        }
-        return static_cast<bound_method_t>(nullptr);
+        return self.is_bound_method() ? self.as_bound_method() : static_cast<bound_method_t>(nullptr);
     }
 
     // Module
     template <typename Self>
     inline auto as_if_module(this Self&& self) noexcept {
-        if (auto obj = self.get_object_ptr()) {
-            if (obj->get_type() == ObjectType::MODULE) {
-                return reinterpret_cast<module_t>(obj);
-            }
-        }
-        return static_cast<module_t>(nullptr);
+        return self.is_module() ? self.as_module() : static_cast<module_t>(nullptr);
     }
 
     // === Visitor ===
@@ -313,4 +302,27 @@ public:
     }
 };
 
+// --- Small int arithmetic ---
+// Operand phải là small int. Operand được dịch lên (64 - SMALL_INT_BITS) bit nên cờ tràn của phép tính
+// 64-bit cũng chính là cờ "kết quả ra ngoài small int": đường nhanh chỉ thêm một lệnh nhảy theo cờ.
+// Trả về false khi kết quả không vừa small int, caller tự tính lại trên đủ 64 bit rồi box.
+inline constexpr unsigned SMALL_INT_SHIFT = 64 - Value::SMALL_INT_BITS;
+
+inline bool small_int_add(int_t lhs, int_t rhs, int_t& out) noexcept {
+    if (__builtin_add_overflow(lhs << SMALL_INT_SHIFT, rhs << SMALL_INT_SHIFT, &out)) return false;
+    out >>= SMALL_INT_SHIFT;
+    return true;
+}
+inline bool small_int_sub(int_t lhs, int_t rhs, int_t& out) noexcept {
+    if (__builtin_sub_overflow(lhs << SMALL_INT_SHIFT, rhs << SMALL_INT_SHIFT, &out)) return false;
+    out >>= SMALL_INT_SHIFT;
+    return true;
+}
+// Chỉ cần dịch một vế: (lhs << k) * rhs == (lhs * rhs) << k
+inline bool small_int_mul(int_t lhs, int_t rhs, int_t& out) noexcept {
+    if (__builtin_mul_overflow(lhs << SMALL_INT_SHIFT, rhs, &out)) return false;
+    out >>= SMALL_INT_SHIFT;
+    return true;
+}
+
 }
\ No newline at end of file
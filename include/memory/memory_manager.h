@@ -24,6 +24,13 @@ public:
     class_t new_class(string_t name = nullptr) noexcept;
     instance_t new_instance(class_t klass) noexcept;
     bound_method_t new_bound_method(instance_t instance, function_t function) noexcept;
+    boxed_int_t new_boxed_int(int_t value) noexcept;
+
+    // Số vừa small int thì nằm thẳng trong Value, ngoài khoảng đó mới box lên heap
+    inline value_t new_int(int_t value) noexcept {
+        if (Value::fits_small_int(value)) [[likely]] return Value::small_int(value);
+        return Value(static_cast<object_t>(new_boxed_int(value)));
+    }
 
     inline void enable_gc() noexcept {
         gc_enabled_ = true;
@@ -45,6 +52,9 @@ private:
 
     std::unique_ptr<GarbageCollector> gc_;
     std::unordered_map<std::string, string_t, StringHash, std::equal_to<>> string_pool_;
+    // Mỗi chuỗi intern nhận một symbol id, 0 để dành cho ô trống của SymbolMap. 64-bit để bộ đếm không
+    // bao giờ quay vòng về 0 (32-bit có thể tràn sau ~4 tỉ chuỗi intern trong một phiên chạy dài).
+    uint64_t next_symbol_id_ = 1;
 
     size_t gc_threshold_;
     size_t object_allocated_;
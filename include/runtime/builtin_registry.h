@@ -4,12 +4,13 @@
 #include "core/objects/string.h"
 #include "common/definitions.h"
 #include "core/value.h"
+#include "core/symbol_map.h"
 #include "memory/gc_visitor.h"
 
 namespace meow {
 struct BuiltinRegistry {
-    std::unordered_map<string_t, std::unordered_map<string_t, Value>> methods;
-    std::unordered_map<string_t, std::unordered_map<string_t, Value>> getters;
+    SymbolMap<SymbolMap<Value>> methods;
+    SymbolMap<SymbolMap<Value>> getters;
 
     inline void trace(GCVisitor& visitor) const noexcept {
         for (const auto& [name, method] : methods) {
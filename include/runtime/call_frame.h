@@ -1,16 +1,30 @@
 #pragma once
 
 #include "common/definitions.h"
+#include "core/objects/function.h"
 
 namespace meow {
-struct CallFrame {
+// Một frame gói gọn trong đúng một cache line: ngoài closure / module / ip còn cache sẵn proto
+// và bảng hằng để CALL / RETURN không phải đi qua function_->get_proto()->get_chunk().
+struct alignas(64) CallFrame {
     function_t function_;
     module_t module_;
     size_t start_reg_;
     size_t ret_reg_;
     const uint8_t* ip_;
-    CallFrame(function_t function, module_t module, size_t start_reg, size_t ret_reg, const uint8_t* ip)
-        : function_(function), module_(module), start_reg_(start_reg), ret_reg_(ret_reg), ip_(ip) {
+    proto_t proto_;
+    // Frame của constructor (init): instance đang được dựng, trả về cho caller thay cho giá trị của init.
+    // nullptr với mọi frame khác.
+    instance_t constructed_;
+    const Value* constants_;
+
+    CallFrame(function_t function, module_t module, size_t start_reg, size_t ret_reg, instance_t constructed = nullptr) noexcept
+        : function_(function), module_(module), start_reg_(start_reg), ret_reg_(ret_reg), proto_(function->get_proto()),
+          constructed_(constructed) {
+        const Chunk& chunk = proto_->get_chunk();
+        constants_ = chunk.get_constants();
+        ip_ = chunk.get_stream();
     }
 };
-}
\ No newline at end of file
+static_assert(sizeof(CallFrame) == 64, "CallFrame must fit in one cache line");
+}
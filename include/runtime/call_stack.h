@@ -0,0 +1,61 @@
+#pragma once
+
+#include "common/pch.h"
+#include "runtime/call_frame.h"
+#include "vm/vm_error.h"
+
+// Độ sâu gọi hàm tối đa, có thể đặt qua CMake
+#if !defined(MEOW_CALL_STACK_LIMIT)
+#define MEOW_CALL_STACK_LIMIT (1u << 16)
+#endif
+
+namespace meow {
+// Stack frame liên tục, cấp phát một lần với sức chứa cố định. Frame được dựng tại chỗ và không bao
+// giờ bị dời, nên current_frame_ (và mọi CallFrame*) vẫn hợp lệ qua các lần push / pop.
+class CallStack {
+public:
+    static constexpr size_t DEFAULT_LIMIT = MEOW_CALL_STACK_LIMIT;
+
+    explicit CallStack(size_t limit = DEFAULT_LIMIT)
+        : frames_(static_cast<CallFrame*>(::operator new(limit * sizeof(CallFrame), std::align_val_t{alignof(CallFrame)}))),
+          limit_(limit) {}
+    CallStack(const CallStack&) = delete;
+    CallStack(CallStack&&) = delete;
+    CallStack& operator=(const CallStack&) = delete;
+    CallStack& operator=(CallStack&&) = delete;
+    ~CallStack() noexcept {
+        ::operator delete(frames_, std::align_val_t{alignof(CallFrame)});
+    }
+
+    // --- Accessors ---
+    inline size_t size() const noexcept { return top_; }
+    inline bool empty() const noexcept { return top_ == 0; }
+    inline size_t limit() const noexcept { return limit_; }
+
+    inline CallFrame& back() noexcept { return frames_[top_ - 1]; }
+    inline const CallFrame& back() const noexcept { return frames_[top_ - 1]; }
+    inline CallFrame& operator[](size_t index) noexcept { return frames_[index]; }
+    inline const CallFrame& operator[](size_t index) const noexcept { return frames_[index]; }
+
+    inline const CallFrame* begin() const noexcept { return frames_; }
+    inline const CallFrame* end() const noexcept { return frames_ + top_; }
+
+    // --- Modifiers ---
+    // Vượt quá limit() sẽ ném VMError (stack overflow)
+    template <typename... Args>
+    inline CallFrame& emplace_back(Args&&... args) {
+        if (top_ == limit_) [[unlikely]] {
+            throw VMError(std::format("Stack overflow: call depth limit of {} frames exceeded.", limit_));
+        }
+        return *std::construct_at(frames_ + top_++, std::forward<Args>(args)...);
+    }
+
+    // CallFrame trivially destructible: pop chỉ là lùi top, frame vừa pop vẫn đọc được cho tới lần push kế
+    inline void pop_back() noexcept { --top_; }
+    inline void clear() noexcept { top_ = 0; }
+private:
+    CallFrame* frames_;
+    size_t top_ = 0;
+    size_t limit_;
+};
+}
@@ -8,7 +8,12 @@
 
 namespace meow {
 inline bool recover_from_error(const VMError& e, ExecutionContext* context, MemoryManager* heap) noexcept {
-    printl("Exception caught: {}", e.what());
+    if (context->current_frame_) {
+        const Chunk& chunk = context->current_frame_->proto_->get_chunk();
+        printl("Exception caught: {} (at bytecode offset {})", e.what(), chunk.source_offset(context->current_frame_->ip_));
+    } else {
+        printl("Exception caught: {}", e.what());
+    }
 
     if (context->exception_handlers_.empty()) {
         printl("Uncaught exception! VM Halting.");
@@ -27,17 +32,17 @@ inline bool recover_from_error(const VMError& e, ExecutionContext* context, Memo
         context->call_stack_.pop_back();
     }
 
-    // 3. Khôi phục Register Stack
-    context->registers_.resize(handler.stack_depth_);
-
-    // 4. Khôi phục ExecutionContext
+    // 3. Khôi phục ExecutionContext
     context->current_frame_ = &context->call_stack_.back();
     context->current_base_ = context->current_frame_->start_reg_;
+
+    // 4. Khôi phục Register Stack: cửa sổ các frame đã unwind có thể nằm chồng trong cửa sổ của frame
+    // bắt lỗi, nên đỉnh stack được đưa về đúng cuối cửa sổ frame này (giống RETURN)
+    context->registers_.resize(context->current_base_ + context->current_frame_->proto_->get_num_registers());
     
     // 5. Cập nhật IP để nhảy tới Catch Block
     // (Lưu ý: IP trong frame phải trỏ đúng chỗ để lần lặp sau dùng)
-    const uint8_t* code_start = context->current_frame_->function_->get_proto()->get_chunk().get_code();
-    context->current_frame_->ip_ = code_start + handler.catch_ip_;
+    context->current_frame_->ip_ = context->current_frame_->proto_->get_chunk().get_stream() + handler.catch_ip_;
 
     // 6. Ghi lỗi vào Register (nếu cần)
     if (handler.error_reg_ != static_cast<size_t>(-1)) {
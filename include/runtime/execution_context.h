@@ -5,16 +5,22 @@
 #include "core/objects/function.h"
 #include "core/value.h"
 #include "memory/gc_visitor.h"
-#include "runtime/call_frame.h"
+#include "runtime/call_stack.h"
 #include "runtime/exception_handler.h"
+#include "runtime/register_stack.h"
+#include "runtime/stub_cache.h"
 
 namespace meow {
 
 struct ExecutionContext {
-    std::vector<CallFrame> call_stack_;
-    std::vector<Value> registers_;
-    std::vector<upvalue_t> open_upvalues_;
+    CallStack call_stack_;
+    RegisterStack registers_;
+    // Upvalue đang mở: danh sách móc nối qua ObjUpvalue::next_open_, sắp theo register giảm dần
+    // (đầu danh sách là register cao nhất), kèm bảng tra theo register tuyệt đối
+    upvalue_t open_upvalues_ = nullptr;
+    std::vector<upvalue_t> open_upvalue_at_;
     std::vector<ExceptionHandler> exception_handlers_;
+    StubCache stub_cache_;
 
     size_t current_base_ = 0;
     CallFrame* current_frame_ = nullptr;
@@ -22,17 +28,23 @@ struct ExecutionContext {
     inline void reset() noexcept {
         call_stack_.clear();
         registers_.clear();
-        open_upvalues_.clear();
+        open_upvalues_ = nullptr;
+        open_upvalue_at_.clear();
         exception_handlers_.clear();
+        stub_cache_.clear();
     }
 
     inline void trace(GCVisitor& visitor) const noexcept {
         for (const auto& reg : registers_) {
             visitor.visit_value(reg);
         }
-        for (const auto& upvalue : open_upvalues_) {
+        for (const CallFrame& frame : call_stack_) {
+            if (frame.constructed_) visitor.visit_object(frame.constructed_);
+        }
+        for (upvalue_t upvalue = open_upvalues_; upvalue; upvalue = upvalue->get_next_open()) {
             visitor.visit_object(upvalue);
         }
+        stub_cache_.trace(visitor);
     }
 };
 }
\ No newline at end of file
@@ -24,32 +24,42 @@ inline constexpr size_t operator+(OpCode op_code) noexcept {
 inline ValueType get_value_type(param_t value) noexcept {
     ValueType type = static_cast<ValueType>(value.index());
     if (type == ValueType::Object) {
-        return static_cast<ValueType>(value.as_object()->get_type());
+        // Int đã box dùng chung ô của Int: toán tử không cần biết số nằm ở đâu
+        if (value.is_boxed_int()) return ValueType::Int;
+        return static_cast<ValueType>(value.object_type());
     }
     return type;
 }
 
+struct OperatorTables {
+    binary_function_t binary_[NUM_OPCODES][NUM_VALUE_TYPES][NUM_VALUE_TYPES]{};
+    unary_function_t unary_[NUM_OPCODES][NUM_VALUE_TYPES]{};
+};
+
+// Bảng toán tử đầy đủ, dựng lúc compile (constexpr) trong operator_dispatcher.cpp. Nằm trong vùng
+// read-only và dùng chung cho mọi Machine; ô null nghĩa là toán tử không hỗ trợ cặp kiểu đó.
+extern const OperatorTables OPERATOR_TABLES;
+
+// Không giữ state: heap được truyền thẳng vào từng hàm toán tử lúc gọi
 class OperatorDispatcher {
 public:
-    explicit OperatorDispatcher(MemoryManager* heap) noexcept;
-
     inline binary_function_t find(OpCode op, ValueType lhs, ValueType rhs) const noexcept {
-        return binary_dispatch_table_[+op][+lhs][+rhs]; 
+        return OPERATOR_TABLES.binary_[+op][+lhs][+rhs];
     }
 
     inline unary_function_t find(OpCode op, ValueType rhs) const noexcept {
-        return unary_dispatch_table_[+op][+rhs];
+        return OPERATOR_TABLES.unary_[+op][+rhs];
     }
 
     inline binary_function_t find(OpCode op, param_t left, param_t right) const noexcept {
         auto lhs = get_value_type(left);
         auto rhs = get_value_type(right);
-        return binary_dispatch_table_[+op][+lhs][+rhs];
+        return OPERATOR_TABLES.binary_[+op][+lhs][+rhs];
     }
 
     inline unary_function_t find(OpCode op, param_t right) const noexcept {
         auto rhs = get_value_type(right);
-        return unary_dispatch_table_[+op][+rhs];
+        return OPERATOR_TABLES.unary_[+op][+rhs];
     }
 
     inline binary_function_t operator[](OpCode op, ValueType lhs, ValueType rhs) const noexcept {
@@ -67,9 +77,5 @@ public:
     inline unary_function_t operator[](OpCode op, param_t right) const noexcept {
         return find(op, right);
     }
-private:
-    [[maybe_unused]] MemoryManager* heap_;
-    binary_function_t binary_dispatch_table_[NUM_OPCODES][NUM_VALUE_TYPES][NUM_VALUE_TYPES];
-    unary_function_t unary_dispatch_table_[NUM_OPCODES][NUM_VALUE_TYPES];
 };
 }
\ No newline at end of file
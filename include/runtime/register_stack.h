@@ -0,0 +1,67 @@
+#pragma once
+
+#include "common/pch.h"
+#include "core/value.h"
+
+// Số register tối đa của toàn bộ stack (mọi frame cộng lại), có thể đặt qua CMake
+#if !defined(MEOW_REGISTER_STACK_LIMIT)
+#define MEOW_REGISTER_STACK_LIMIT (1u << 20)
+#endif
+
+namespace meow {
+// Register stack dùng chung cho mọi frame. Cả vùng [0, limit) được reserve một lần trong address
+// space rồi commit dần theo từng khối khi stack lớn lên, nên không bao giờ bị dời chỗ: Value* / Value&
+// lấy từ stack vẫn hợp lệ qua CALL, IMPORT_MODULE và RETURN. Vào/ra frame chỉ là dịch con trỏ top.
+class RegisterStack {
+public:
+    static constexpr size_t DEFAULT_LIMIT = MEOW_REGISTER_STACK_LIMIT;
+
+    explicit RegisterStack(size_t limit = DEFAULT_LIMIT);
+    RegisterStack(const RegisterStack&) = delete;
+    RegisterStack(RegisterStack&&) = delete;
+    RegisterStack& operator=(const RegisterStack&) = delete;
+    RegisterStack& operator=(RegisterStack&&) = delete;
+    ~RegisterStack() noexcept;
+
+    // --- Accessors ---
+    inline Value* data() noexcept { return base_; }
+    inline const Value* data() const noexcept { return base_; }
+    inline size_t size() const noexcept { return top_; }
+    inline bool empty() const noexcept { return top_ == 0; }
+    inline size_t limit() const noexcept { return limit_; }
+
+    inline Value& operator[](size_t index) noexcept { return base_[index]; }
+    inline const Value& operator[](size_t index) const noexcept { return base_[index]; }
+
+    inline const Value* begin() const noexcept { return base_; }
+    inline const Value* end() const noexcept { return base_ + top_; }
+
+    // --- Modifiers ---
+    // Thu nhỏ chỉ dời top. Mở rộng thì các slot mới được đặt về null vì GC quét toàn bộ [0, size()).
+    // Vượt quá limit() sẽ ném VMError (stack overflow).
+    inline void resize(size_t new_size) {
+        if (new_size > top_) {
+            // Kiểm tra limit trước: phần commit được làm tròn theo khối nên committed_ có thể vượt limit_
+            if (new_size > limit_) [[unlikely]] {
+                throw_overflow();
+            }
+            if (new_size > committed_) [[unlikely]] {
+                commit(new_size);
+            }
+            std::uninitialized_fill(base_ + top_, base_ + new_size, Value(null_t{}));
+        }
+        top_ = new_size;
+    }
+
+    inline void clear() noexcept { top_ = 0; }
+private:
+    Value* base_ = nullptr;
+    size_t top_ = 0;
+    size_t committed_ = 0;
+    size_t limit_ = 0;
+    size_t reserved_bytes_ = 0;
+
+    void commit(size_t new_size);
+    [[noreturn]] void throw_overflow() const;
+};
+}
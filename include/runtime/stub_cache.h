@@ -0,0 +1,85 @@
+#pragma once
+
+#include "common/pch.h"
+#include "common/definitions.h"
+#include "bytecode/inline_cache.h"
+#include "core/objects/oop.h"
+#include "memory/gc_visitor.h"
+
+// Số entry của stub cache (luỹ thừa của 2), có thể đặt qua CMake
+#if !defined(MEOW_STUB_CACHE_SIZE)
+#define MEOW_STUB_CACHE_SIZE 1024
+#endif
+
+namespace meow {
+
+struct StubCacheStats {
+    uint64_t hits_ = 0;
+    uint64_t misses_ = 0;
+    uint64_t evictions_ = 0;
+};
+
+// Cache tra property dùng chung cho cả VM, đứng sau inline cache của từng lệnh: site megamorphic
+// (thấy quá nhiều shape) vẫn tránh được việc tra bảng băm. Bảng băm địa chỉ trực tiếp, kích thước
+// cố định; key là (shape id, tên đã intern), trùng ô thì entry mới đè entry cũ.
+// Chỉ lưu kết quả đọc (slot của field hoặc method của class), không lưu transition của SET_PROP.
+class StubCache {
+public:
+    static constexpr size_t SIZE = MEOW_STUB_CACHE_SIZE;
+    static_assert(SIZE > 0 && (SIZE & (SIZE - 1)) == 0, "MEOW_STUB_CACHE_SIZE must be a power of two");
+
+    // Entry hợp lệ cho (shape, name), nullptr nếu trượt. Method chỉ hợp lệ khi method version
+    // của class chưa đổi kể từ lúc được cache.
+    inline const PropertyCacheEntry* lookup(uint32_t shape_id, string_t name, class_t klass) noexcept {
+        const Entry& entry = entries_[index_of(shape_id, name)];
+        if (entry.name_ == name && entry.target_.shape_id_ == shape_id &&
+            (entry.target_.slot_ != Shape::NOT_FOUND || entry.target_.version_ == klass->get_method_version())) {
+            ++stats_.hits_;
+            return &entry.target_;
+        }
+        ++stats_.misses_;
+        return nullptr;
+    }
+
+    inline void insert(string_t name, const PropertyCacheEntry& target) noexcept {
+        Entry& entry = entries_[index_of(target.shape_id_, name)];
+        if (entry.name_ != nullptr && (entry.name_ != name || entry.target_.shape_id_ != target.shape_id_)) {
+            ++stats_.evictions_;
+        }
+        entry.name_ = name;
+        entry.target_ = target;
+    }
+
+    inline void clear() noexcept {
+        entries_.fill(Entry{});
+    }
+
+    inline const StubCacheStats& get_stats() const noexcept {
+        return stats_;
+    }
+
+    // Giữ sống tên và method đang được cache: tên bị thu hồi rồi cấp phát lại đúng địa chỉ cũ sẽ làm trùng key
+    inline void trace(GCVisitor& visitor) const noexcept {
+        for (const auto& entry : entries_) {
+            if (entry.name_ == nullptr) continue;
+            visitor.visit_object(entry.name_);
+            visitor.visit_value(entry.target_.method_);
+        }
+    }
+
+private:
+    struct Entry {
+        string_t name_ = nullptr;
+        PropertyCacheEntry target_;
+    };
+
+    std::array<Entry, SIZE> entries_{};
+    StubCacheStats stats_;
+
+    static inline size_t index_of(uint32_t shape_id, string_t name) noexcept {
+        uint64_t key = (static_cast<uint64_t>(shape_id) * 0x9E3779B97F4A7C15ull) ^ name->get_symbol();
+        return static_cast<size_t>((key ^ (key >> 29)) & (SIZE - 1));
+    }
+};
+
+}
@@ -7,28 +7,48 @@
 
 namespace meow {
 inline upvalue_t capture_upvalue(ExecutionContext* context, MemoryManager* heap, size_t register_index) noexcept {
-    // Tìm kiếm các upvalue đã mở từ trên xuống dưới (chỉ số stack cao -> thấp)
-    for (auto it = context->open_upvalues_.rbegin(); it != context->open_upvalues_.rend(); ++it) {
-        upvalue_t uv = *it;
-        if (uv->get_index() == register_index) return uv;
-        if (uv->get_index() < register_index) break;  // Đã đi qua, không cần tìm nữa
+    // Register đã có upvalue mở thì dùng lại: tra thẳng theo chỉ số
+    auto& open_at = context->open_upvalue_at_;
+    if (register_index < open_at.size() && open_at[register_index]) {
+        return open_at[register_index];
     }
 
-    // Không tìm thấy, tạo mới
     upvalue_t new_uv = heap->new_upvalue(register_index);
+    if (register_index >= open_at.size()) {
+        open_at.resize(std::max(register_index + 1, context->registers_.size()), nullptr);
+    }
+    open_at[register_index] = new_uv;
 
-    // Chèn vào danh sách đã sắp xếp (theo chỉ số stack)
-    auto it = std::lower_bound(context->open_upvalues_.begin(), context->open_upvalues_.end(), new_uv, [](auto a, auto b) { return a->get_index() < b->get_index(); });
-    context->open_upvalues_.insert(it, new_uv);
+    // Chèn vào danh sách (register giảm dần). Capture gần như luôn ở frame trên cùng nên
+    // vòng lặp thường dừng ngay ở đầu danh sách
+    upvalue_t prev = nullptr;
+    upvalue_t curr = context->open_upvalues_;
+    while (curr && curr->get_index() > register_index) {
+        prev = curr;
+        curr = curr->get_next_open();
+    }
+    new_uv->set_next_open(curr);
+    if (prev) {
+        prev->set_next_open(new_uv);
+    } else {
+        context->open_upvalues_ = new_uv;
+    }
     return new_uv;
 }
 
 inline void close_upvalues(ExecutionContext* context, size_t last_index) noexcept {
-    // Đóng tất cả upvalue có chỉ số register >= last_index
-    while (!context->open_upvalues_.empty() && context->open_upvalues_.back()->get_index() >= last_index) {
-        upvalue_t uv = context->open_upvalues_.back();
-        uv->close(context->registers_[uv->get_index()]);
-        context->open_upvalues_.pop_back();
-    }
+    // Đóng tất cả upvalue có chỉ số register >= last_index. Frame không capture gì chỉ tốn một phép so sánh
+    upvalue_t uv = context->open_upvalues_;
+    if (!uv || uv->get_index() < last_index) [[likely]] return;
+
+    do {
+        size_t index = uv->get_index();
+        uv->close(context->registers_[index]);
+        context->open_upvalue_at_[index] = nullptr;
+        upvalue_t next = uv->get_next_open();
+        uv->set_next_open(nullptr);
+        uv = next;
+    } while (uv && uv->get_index() >= last_index);
+    context->open_upvalues_ = uv;
 }
 }
@@ -1,15 +1,19 @@
 #pragma once
 
 #include "common/pch.h"
+#include "common/definitions.h"
 #include "vm/meow_engine.h"
 #include "vm/vm_error.h"
 
 namespace meow {
+class Value;
 struct ExecutionContext;
 struct BuiltinRegistry;
 class OperatorDispatcher;
 class MemoryManager;
 class ModuleManager;
+struct PropertyCache;
+struct PropertyCacheEntry;
 
 struct VMArgs {
     std::vector<std::string> command_line_arguments_;
@@ -18,6 +22,7 @@ struct VMArgs {
 };
 
 class Machine : public MeowEngine {
+    friend struct TailCallEngine;
 public:
     // --- Constructors ---
     explicit Machine(const std::string& entry_point_directory, const std::string& entry_path, int argc, char* argv[]);
@@ -43,43 +48,58 @@ private:
     void prepare() noexcept;
     void run();
 
+    // Bảng handler của vòng dispatch, dùng để thread chunk lần đầu được chạy
+    const void* const* dispatch_table_ = nullptr;
+    inline void call_value(size_t ret_reg, uint16_t fn_reg, uint16_t arg_start, uint16_t argc);
+    inline void call_callee(Value callee, size_t ret_reg, uint16_t fn_reg, uint16_t arg_start, uint16_t argc);
+    inline void push_frame(size_t ret_reg, function_t closure, instance_t self, uint16_t self_reg, uint16_t arg_start, uint16_t argc,
+                           bool is_constructor_call);
+    inline void invoke_method(size_t ret_reg, uint16_t obj_reg, string_t name, uint16_t arg_start, uint16_t argc, PropertyCache* cache);
+    inline bool tail_call_value(uint16_t fn_reg, uint16_t arg_start, uint16_t argc);
+    inline bool return_from_frame(Value return_value);
+    inline void open_window(size_t new_base, size_t num_args, size_t num_registers);
+
+    inline bool resolve_property(instance_t inst, string_t name, PropertyCache* cache, PropertyCacheEntry& out);
+    inline void get_prop_slow(Value& dst, Value& obj, string_t name, PropertyCache* cache);
+    inline void set_prop_slow(Value& obj, string_t name, Value& val, PropertyCache* cache);
+
     // --- Error helpers ---
     [[noreturn]] inline void throw_vm_error(const std::string& message) {
         throw VMError(message);
     }
 
     // --- OpCode Handlers (Helpers) ---
-    inline void op_load_const(const uint8_t*& ip);
-    inline void op_load_null(const uint8_t*& ip);
-    inline void op_load_true(const uint8_t*& ip);
-    inline void op_load_false(const uint8_t*& ip);
-    inline void op_load_int(const uint8_t*& ip);
-    inline void op_load_float(const uint8_t*& ip);
-    inline void op_move(const uint8_t*& ip);
-    inline void op_get_global(const uint8_t*& ip);
-    inline void op_set_global(const uint8_t*& ip);
-    inline void op_get_upvalue(const uint8_t*& ip);
-    inline void op_set_upvalue(const uint8_t*& ip);
-    inline void op_closure(const uint8_t*& ip);
-    inline void op_close_upvalues(const uint8_t*& ip);
-    inline void op_new_array(const uint8_t*& ip);
-    inline void op_new_hash(const uint8_t*& ip);
-    inline void op_get_index(const uint8_t*& ip);
-    inline void op_set_index(const uint8_t*& ip);
-    inline void op_get_keys(const uint8_t*& ip);
-    inline void op_get_values(const uint8_t*& ip);
-    inline void op_new_class(const uint8_t*& ip);
-    inline void op_new_instance(const uint8_t*& ip);
-    inline void op_get_prop(const uint8_t*& ip);
-    inline void op_set_prop(const uint8_t*& ip);
-    inline void op_set_method(const uint8_t*& ip);
-    inline void op_inherit(const uint8_t*& ip);
-    inline void op_get_super(const uint8_t*& ip);
-    inline void op_throw(const uint8_t*& ip);
-    inline void op_setup_try(const uint8_t*& ip);
+    inline void op_load_const(const uint8_t*& ip, Value* regs, const Value* constants);
+    inline void op_load_null(const uint8_t*& ip, Value* regs, const Value* constants);
+    inline void op_load_true(const uint8_t*& ip, Value* regs, const Value* constants);
+    inline void op_load_false(const uint8_t*& ip, Value* regs, const Value* constants);
+    inline void op_load_int(const uint8_t*& ip, Value* regs, const Value* constants);
+    inline void op_load_float(const uint8_t*& ip, Value* regs, const Value* constants);
+    inline void op_move(const uint8_t*& ip, Value* regs, const Value* constants);
+    inline void op_get_global(const uint8_t*& ip, Value* regs, const Value* constants);
+    inline void op_set_global(const uint8_t*& ip, Value* regs, const Value* constants);
+    inline void op_get_upvalue(const uint8_t*& ip, Value* regs, const Value* constants);
+    inline void op_set_upvalue(const uint8_t*& ip, Value* regs, const Value* constants);
+    inline void op_closure(const uint8_t*& ip, Value* regs, const Value* constants);
+    inline void op_close_upvalues(const uint8_t*& ip, Value* regs, const Value* constants);
+    inline void op_new_array(const uint8_t*& ip, Value* regs, const Value* constants);
+    inline void op_new_hash(const uint8_t*& ip, Value* regs, const Value* constants);
+    inline void op_get_index(const uint8_t*& ip, Value* regs, const Value* constants);
+    inline void op_set_index(const uint8_t*& ip, Value* regs, const Value* constants);
+    inline void op_get_keys(const uint8_t*& ip, Value* regs, const Value* constants);
+    inline void op_get_values(const uint8_t*& ip, Value* regs, const Value* constants);
+    inline void op_new_class(const uint8_t*& ip, Value* regs, const Value* constants);
+    inline void op_new_instance(const uint8_t*& ip, Value* regs, const Value* constants);
+    inline void op_get_prop(const uint8_t*& ip, Value* regs, const Value* constants);
+    inline void op_set_prop(const uint8_t*& ip, Value* regs, const Value* constants);
+    inline void op_set_method(const uint8_t*& ip, Value* regs, const Value* constants);
+    inline void op_inherit(const uint8_t*& ip, Value* regs, const Value* constants);
+    inline void op_get_super(const uint8_t*& ip, Value* regs, const Value* constants);
+    inline void op_throw(const uint8_t*& ip, Value* regs, const Value* constants);
+    inline void op_setup_try(const uint8_t*& ip, Value* regs, const Value* constants);
     inline void op_pop_try();
-    inline void op_export(const uint8_t*& ip);
-    inline void op_get_export(const uint8_t*& ip);
-    inline void op_import_all(const uint8_t*& ip);
+    inline void op_export(const uint8_t*& ip, Value* regs, const Value* constants);
+    inline void op_get_export(const uint8_t*& ip, Value* regs, const Value* constants);
+    inline void op_import_all(const uint8_t*& ip, Value* regs, const Value* constants);
 };
 }
\ No newline at end of file
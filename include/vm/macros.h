@@ -1,53 +1,348 @@
 #pragma once
 
-#define READ_BYTE() (*ip++)
-#define READ_U16() (ip += 2, (uint16_t)((ip[-2] | (ip[-1] << 8))))
-#define READ_U64()                                                                                                                                                                 \
-    (ip += 8, (uint64_t)(ip[-8]) | ((uint64_t)(ip[-7]) << 8) | ((uint64_t)(ip[-6]) << 16) | ((uint64_t)(ip[-5]) << 24) | ((uint64_t)(ip[-4]) << 32) | ((uint64_t)(ip[-3]) << 40) | \
-                  ((uint64_t)(ip[-2]) << 48) | ((uint64_t)(ip[-1]) << 56))
+// --- Decoded stream ---
+// ip chạy trên stream đã giải mã (xem InstructionRecord trong bytecode/chunk.h). Operand đã
+// được căn lề tự nhiên nên chỉ cần một lệnh load, không còn ghép từng byte như bytecode gốc.
+#define ALIGN_IP(n) \
+    (ip = reinterpret_cast<const uint8_t*>((reinterpret_cast<uintptr_t>(ip) + ((n) - 1)) & ~static_cast<uintptr_t>((n) - 1)))
+
+#define READ_U16() (ip += 2, load_operand<uint16_t>(ip - 2))
+#define READ_U64() (ALIGN_IP(8), ip += 8, load_operand<uint64_t>(ip - 8))
 
 #define READ_I64() (std::bit_cast<int64_t>(READ_U64()))
 #define READ_F64() (std::bit_cast<double>(READ_U64()))
-#define READ_ADDRESS() READ_U16()
+#define READ_ADDRESS() (ALIGN_IP(4), ip += 4, load_operand<uint32_t>(ip - 4))
+
+// Đích nhảy được lưu tương đối so với vị trí ngay sau operand
+#define READ_JUMP() (ALIGN_IP(4), ip += 4, load_operand<int32_t>(ip - 4))
+#define JUMP_BY(offset) (ip += (offset))
+
+// Con trỏ tới inline cache riêng của lệnh (operand 'c', điền lúc thread chunk)
+#define READ_INLINE_CACHE() (ALIGN_IP(8), ip += 8, load_operand<PropertyCache*>(ip - 8))
+#define READ_EXPORT_CACHE() (ALIGN_IP(8), ip += 8, load_operand<ExportCache*>(ip - 8))
+
+#define CURRENT_CHUNK() (vm->context_->current_frame_->proto_->get_chunk())
+
+// regs / constants là biến cục bộ của run() (và tham số của các handler helper),
+// chỉ được nạp lại khi đổi frame hoặc unwind (register stack không bao giờ bị dời chỗ).
+// `vm` là Machine đang chạy: `this` trong run(), tham số đầu tiên ở engine tail-call.
+#define READ_CONSTANT() (constants[READ_U16()])
+#define REGISTER(idx) (regs[(idx)])
+#define CONSTANT(idx) (constants[(idx)])
+
+#define RELOAD_REGISTERS() (regs = vm->context_->registers_.data() + vm->context_->current_base_)
+#define LOAD_FRAME() \
+    do { \
+        ip = vm->context_->current_frame_->ip_; \
+        RELOAD_REGISTERS(); \
+        constants = vm->context_->current_frame_->constants_; \
+    } while (0)
 
-#define CURRENT_CHUNK() (context_->current_frame_->function_->get_proto()->get_chunk())
-#define READ_CONSTANT() (CURRENT_CHUNK().get_constant(READ_U16()))
+// Frame mới được push: thread chunk nếu đây là lần đầu nó được chạy rồi nạp frame
+#define ENTER_FRAME() \
+    do { \
+        const Chunk& entered_chunk = CURRENT_CHUNK(); \
+        if (!entered_chunk.is_threaded()) [[unlikely]] { \
+            const_cast<Chunk&>(entered_chunk).thread(vm->dispatch_table_); \
+        } \
+        LOAD_FRAME(); \
+    } while (0)
 
-#define REGISTER(idx) (context_->registers_[context_->current_base_ + (idx)])
-#define CONSTANT(idx) (CURRENT_CHUNK().get_constant(idx))
+// Chỉ những lệnh có thể throw, cấp phát hoặc gọi hàm mới ghi ip về frame
+#define SAVE_IP() (vm->context_->current_frame_->ip_ = ip)
 
 #define UNARY_OP_HANDLER(OPCODE, OPNAME) \
-    op_##OPCODE: { \
+    HANDLER(OPCODE) { \
         uint16_t dst = READ_U16(); \
         uint16_t src = READ_U16(); \
         auto& val = REGISTER(src); \
-        if (auto func = op_dispatcher_->find(OpCode::OPCODE, val)) { \
-            REGISTER(dst) = func(heap_.get(), val); \
+        SAVE_IP(); \
+        if (auto func = vm->op_dispatcher_->find(OpCode::OPCODE, val)) { \
+            REGISTER(dst) = func(vm->heap_.get(), val); \
         } else { \
-            throw_vm_error("Unsupported unary operator " OPNAME); \
+            vm->throw_vm_error("Unsupported unary operator " OPNAME); \
         } \
         DISPATCH(); \
     }
 
 #define BINARY_OP_HANDLER(OPCODE, OPNAME) \
-    op_##OPCODE: { \
+    HANDLER(OPCODE) { \
+        uint16_t dst = READ_U16(); \
+        uint16_t r1 = READ_U16(); \
+        uint16_t r2 = READ_U16(); \
+        auto& left = REGISTER(r1); \
+        auto& right = REGISTER(r2); \
+        SAVE_IP(); \
+        if (auto func = vm->op_dispatcher_->find(OpCode::OPCODE, left, right)) { \
+            REGISTER(dst) = func(vm->heap_.get(), left, right); \
+        } else { \
+            vm->throw_vm_error("Unsupported binary operator " OPNAME); \
+        } \
+        DISPATCH(); \
+    }
+
+// --- Quickening ---
+// Các handler generic tự viết lại opcode của chính nó thành bản chuyên biệt theo kiểu
+// operand quan sát được. Bản chuyên biệt chỉ kiểm tra guard rẻ; nếu trượt thì trả opcode
+// về bản generic và chạy lại lệnh từ đầu (deopt).
+// Sau lần deopt đầu tiên, chỗ gọi bị đánh dấu megamorphic và giữ bản generic mãi (QUICKEN thành no-op),
+// để một lệnh gặp cả int lẫn float không bị viết lại qua lại ở mỗi lần chạy. Cờ nằm ở byte trống ngay
+// sau 3 operand u16 (dst, r1, r2) trong record 16 byte của lệnh, decode() để sẵn là 0.
+#define CURRENT_INSTRUCTION() (const_cast<uint8_t*>(ip) - sizeof(const void*))
+#define QUICKEN_STATE(inst) ((inst)[sizeof(const void*) + 3 * sizeof(uint16_t)])
+#define REWRITE_HANDLER(inst, OPCODE) (store_operand<const void*>((inst), vm->dispatch_table_[+OpCode::OPCODE]))
+#define QUICKEN(inst, OPCODE) \
+    do { \
+        if (QUICKEN_STATE(inst) == 0) [[likely]] { \
+            REWRITE_HANDLER(inst, OPCODE); \
+        } \
+    } while (0)
+#define DEOPTIMIZE(inst, GENERIC) \
+    do { \
+        QUICKEN_STATE(inst) = 1; \
+        REWRITE_HANDLER(inst, GENERIC); \
+        ip = (inst) + sizeof(const void*); \
+        JUMP_TO_HANDLER(GENERIC); \
+    } while (0)
+
+// Trộn int/float: int được nâng lên float (cùng quy tắc với bảng toán tử)
+#define IS_NUMBER(value) ((value).is_int() || (value).is_float())
+#define NUMBER_AS_FLOAT(value) ((value).is_int() ? static_cast<double>((value).as_int()) : (value).as_float())
+
+#define BINARY_OP_FALLBACK(OPCODE, OPNAME, dst, left, right) \
+    do { \
+        SAVE_IP(); \
+        if (auto func = vm->op_dispatcher_->find(OpCode::OPCODE, left, right)) { \
+            REGISTER(dst) = func(vm->heap_.get(), left, right); \
+        } else { \
+            vm->throw_vm_error("Unsupported binary operator " OPNAME); \
+        } \
+    } while (0)
+
+// Int +, -, *: small int tính tại chỗ (small_int_add/sub/mul trong core/value.h). Kết quả ra ngoài small
+// int thì tính lại trên đủ 64 bit rồi box lên heap; tràn cả int64 là lỗi.
+#define SMALL_INT_ARITH(dst, CHECKED, OPNAME, lhs, rhs) \
+    do { \
+        int_t int_lhs = (lhs); \
+        int_t int_rhs = (rhs); \
+        int_t int_result; \
+        if (small_int_##CHECKED(int_lhs, int_rhs, int_result)) [[likely]] { \
+            REGISTER(dst) = Value::small_int(int_result); \
+        } else { \
+            SAVE_IP(); \
+            if (__builtin_##CHECKED##_overflow(int_lhs, int_rhs, &int_result)) { \
+                vm->throw_vm_error("Integer overflow in " OPNAME); \
+            } \
+            REGISTER(dst) = vm->heap_->new_int(int_result); \
+        } \
+    } while (0)
+
+// Toán tử bitwise: small int/small int tính ngay tại chỗ (kết quả vẫn là small int), còn lại đi qua
+// dispatcher
+#define INT_BINARY_OP_HANDLER(OPCODE, OPNAME, OPERATOR) \
+    HANDLER(OPCODE) { \
+        uint16_t dst = READ_U16(); \
+        uint16_t r1 = READ_U16(); \
+        uint16_t r2 = READ_U16(); \
+        auto& left = REGISTER(r1); \
+        auto& right = REGISTER(r2); \
+        if (left.is_small_int() && right.is_small_int()) [[likely]] { \
+            REGISTER(dst) = Value::small_int(left.as_small_int() OPERATOR right.as_small_int()); \
+        } else { \
+            BINARY_OP_FALLBACK(OPCODE, OPNAME, dst, left, right); \
+        } \
+        DISPATCH(); \
+    }
+
+// Generic handler: small int/small int -> OPCODE_II, float/float -> OPCODE_FF, int/float trộn tính tại
+// chỗ (không quicken), còn lại (kể cả int đã box) đi qua dispatcher
+#define QUICKENING_ARITH_OP_HANDLER(OPCODE, OPNAME, OPERATOR, CHECKED) \
+    HANDLER(OPCODE) { \
+        uint8_t* inst = CURRENT_INSTRUCTION(); \
+        uint16_t dst = READ_U16(); \
+        uint16_t r1 = READ_U16(); \
+        uint16_t r2 = READ_U16(); \
+        auto& left = REGISTER(r1); \
+        auto& right = REGISTER(r2); \
+        if (left.is_small_int() && right.is_small_int()) { \
+            QUICKEN(inst, OPCODE##_II); \
+            SMALL_INT_ARITH(dst, CHECKED, OPNAME, left.as_small_int(), right.as_small_int()); \
+        } else if (left.is_float() && right.is_float()) { \
+            QUICKEN(inst, OPCODE##_FF); \
+            REGISTER(dst) = Value(left.as_float() OPERATOR right.as_float()); \
+        } else if (IS_NUMBER(left) && IS_NUMBER(right) && !(left.is_int() && right.is_int())) { \
+            REGISTER(dst) = Value(NUMBER_AS_FLOAT(left) OPERATOR NUMBER_AS_FLOAT(right)); \
+        } else { \
+            BINARY_OP_FALLBACK(OPCODE, OPNAME, dst, left, right); \
+        } \
+        DISPATCH(); \
+    }
+
+// Như trên cho toán tử so sánh: int đã box so sánh trên đủ 64 bit, không qua float
+#define QUICKENING_COMPARE_OP_HANDLER(OPCODE, OPNAME, OPERATOR) \
+    HANDLER(OPCODE) { \
+        uint8_t* inst = CURRENT_INSTRUCTION(); \
         uint16_t dst = READ_U16(); \
         uint16_t r1 = READ_U16(); \
         uint16_t r2 = READ_U16(); \
         auto& left = REGISTER(r1); \
         auto& right = REGISTER(r2); \
-        if (auto func = op_dispatcher_->find(OpCode::OPCODE, left, right)) { \
-            REGISTER(dst) = func(heap_.get(), left, right); \
+        if (left.is_small_int() && right.is_small_int()) { \
+            QUICKEN(inst, OPCODE##_II); \
+            REGISTER(dst) = Value(left.as_small_int() OPERATOR right.as_small_int()); \
+        } else if (left.is_float() && right.is_float()) { \
+            QUICKEN(inst, OPCODE##_FF); \
+            REGISTER(dst) = Value(left.as_float() OPERATOR right.as_float()); \
+        } else if (left.is_int() && right.is_int()) { \
+            REGISTER(dst) = Value(left.as_int() OPERATOR right.as_int()); \
+        } else if (IS_NUMBER(left) && IS_NUMBER(right)) { \
+            REGISTER(dst) = Value(NUMBER_AS_FLOAT(left) OPERATOR NUMBER_AS_FLOAT(right)); \
         } else { \
-            throw_vm_error("Unsupported binary operator " OPNAME); \
+            BINARY_OP_FALLBACK(OPCODE, OPNAME, dst, left, right); \
         } \
         DISPATCH(); \
     }
 
+// Specialized handler: chỉ một guard kiểu, trượt guard thì deopt về GENERIC
+#define SPECIALIZED_BINARY_OP_HANDLER(OPCODE, GENERIC, IS_TYPE, AS_TYPE, OPERATOR) \
+    HANDLER(OPCODE) { \
+        uint8_t* inst = CURRENT_INSTRUCTION(); \
+        uint16_t dst = READ_U16(); \
+        uint16_t r1 = READ_U16(); \
+        uint16_t r2 = READ_U16(); \
+        auto& left = REGISTER(r1); \
+        auto& right = REGISTER(r2); \
+        if (left.IS_TYPE() && right.IS_TYPE()) [[likely]] { \
+            REGISTER(dst) = Value(left.AS_TYPE() OPERATOR right.AS_TYPE()); \
+            DISPATCH(); \
+        } \
+        DEOPTIMIZE(inst, GENERIC); \
+    }
+
+#define SPECIALIZED_INT_OP_HANDLER(OPCODE, GENERIC, OPERATOR) \
+    SPECIALIZED_BINARY_OP_HANDLER(OPCODE, GENERIC, is_small_int, as_small_int, OPERATOR)
+#define SPECIALIZED_FLOAT_OP_HANDLER(OPCODE, GENERIC, OPERATOR) \
+    SPECIALIZED_BINARY_OP_HANDLER(OPCODE, GENERIC, is_float, as_float, OPERATOR)
+
+// Guard vẫn chỉ là small int/small int; kết quả tràn small int được box tại chỗ, không deopt
+#define SPECIALIZED_INT_ARITH_HANDLER(OPCODE, GENERIC, OPNAME, CHECKED) \
+    HANDLER(OPCODE) { \
+        uint8_t* inst = CURRENT_INSTRUCTION(); \
+        uint16_t dst = READ_U16(); \
+        uint16_t r1 = READ_U16(); \
+        uint16_t r2 = READ_U16(); \
+        auto& left = REGISTER(r1); \
+        auto& right = REGISTER(r2); \
+        if (left.is_small_int() && right.is_small_int()) [[likely]] { \
+            SMALL_INT_ARITH(dst, CHECKED, OPNAME, left.as_small_int(), right.as_small_int()); \
+            DISPATCH(); \
+        } \
+        DEOPTIMIZE(inst, GENERIC); \
+    }
+
+// --- Compare-and-branch ---
+
+// Trường hợp không phải số: đi qua dispatcher của toán tử so sánh tương ứng rồi to_bool
+#define COMPARE_FALLBACK(GENERIC, OPNAME, left, right) \
+    ([&]() -> bool { \
+        SAVE_IP(); \
+        if (auto func = vm->op_dispatcher_->find(OpCode::GENERIC, left, right)) { \
+            return to_bool(func(vm->heap_.get(), left, right)); \
+        } \
+        vm->throw_vm_error("Unsupported binary operator " OPNAME); \
+    }())
+
+#define COMPARE_JUMP_HANDLER(OPCODE, GENERIC, OPNAME, OPERATOR) \
+    HANDLER(OPCODE) { \
+        uint16_t r1 = READ_U16(); \
+        uint16_t r2 = READ_U16(); \
+        int32_t offset = READ_JUMP(); \
+        auto& left = REGISTER(r1); \
+        auto& right = REGISTER(r2); \
+        bool condition; \
+        if (left.is_small_int() && right.is_small_int()) [[likely]] { \
+            condition = left.as_small_int() OPERATOR right.as_small_int(); \
+        } else if (left.is_float() && right.is_float()) { \
+            condition = left.as_float() OPERATOR right.as_float(); \
+        } else if (left.is_int() && right.is_int()) { \
+            condition = left.as_int() OPERATOR right.as_int(); \
+        } else if (IS_NUMBER(left) && IS_NUMBER(right)) { \
+            condition = NUMBER_AS_FLOAT(left) OPERATOR NUMBER_AS_FLOAT(right); \
+        } else { \
+            condition = COMPARE_FALLBACK(GENERIC, OPNAME, left, right); \
+        } \
+        if (condition) { \
+            JUMP_BY(offset); \
+        } \
+        DISPATCH(); \
+    }
+
+#define COMPARE_IMM_JUMP_HANDLER(OPCODE, GENERIC, OPNAME, OPERATOR) \
+    HANDLER(OPCODE) { \
+        uint16_t r1 = READ_U16(); \
+        int64_t imm = READ_I64(); \
+        int32_t offset = READ_JUMP(); \
+        auto& left = REGISTER(r1); \
+        bool condition; \
+        if (left.is_small_int()) [[likely]] { \
+            condition = left.as_small_int() OPERATOR imm; \
+        } else if (left.is_float()) { \
+            condition = left.as_float() OPERATOR static_cast<double>(imm); \
+        } else if (left.is_boxed_int()) { \
+            condition = left.as_int() OPERATOR imm; \
+        } else { \
+            SAVE_IP(); \
+            Value right = vm->heap_->new_int(imm); \
+            condition = COMPARE_FALLBACK(GENERIC, OPNAME, left, right); \
+        } \
+        if (condition) { \
+            JUMP_BY(offset); \
+        } \
+        DISPATCH(); \
+    }
+
+// --- Superinstructions ---
+// Lệnh gộp chạy xong phần đầu thì nhảy qua ô handler của lệnh thứ hai (vẫn nằm nguyên trong chunk)
+#define SKIP_OPCODE() (ALIGN_IP(sizeof(InstructionRecord)), ip += sizeof(const void*))
+
+// --- Dispatch ---
+// Engine được chọn lúc build (MEOW_DISPATCH_ENGINE trong CMakeLists.txt).
+#if defined(MEOW_USE_TAILCALL_DISPATCH)
+
+#if defined(__clang__) && __has_cpp_attribute(clang::musttail)
+#define MEOW_MUSTTAIL [[clang::musttail]]
+#elif __has_cpp_attribute(gnu::musttail)
+#define MEOW_MUSTTAIL [[gnu::musttail]]
+#else
+#error "MEOW_DISPATCH_ENGINE=tailcall requires a compiler with [[clang::musttail]] or [[gnu::musttail]]"
+#endif
+
+// Mỗi opcode là một hàm; ip / regs / constants nằm yên trong thanh ghi tham số
+#define HANDLER(OPCODE) \
+    static void op_##OPCODE(Machine* vm, const uint8_t* ip, Value* regs, const Value* constants)
+#define JUMP_TO_HANDLER(OPCODE) \
+    MEOW_MUSTTAIL return op_##OPCODE(vm, ip, regs, constants)
+
+#define DISPATCH()                                                                    \
+    do {                                                                              \
+        ALIGN_IP(sizeof(InstructionRecord));                                          \
+        const void* handler = load_operand<const void*>(ip);                          \
+        ip += sizeof(const void*);                                                    \
+        MEOW_MUSTTAIL return reinterpret_cast<TailCallHandler>(const_cast<void*>(handler))( \
+            vm, ip, regs, constants);                                                 \
+    } while (0)
+
+#else
+
+#define HANDLER(OPCODE) op_##OPCODE:
+#define JUMP_TO_HANDLER(OPCODE) goto op_##OPCODE
+
 #define DISPATCH()                                                \
     do {                                                          \
-        context_->current_frame_->ip_ = ip;                       \
-        uint8_t instruction = READ_BYTE();                        \
-        [[assume(instruction < static_cast<size_t>(OpCode::TOTAL_OPCODES))]]; \
-        goto *dispatch_table[instruction];                        \
-    } while (0)
\ No newline at end of file
+        ALIGN_IP(sizeof(InstructionRecord));                      \
+        const void* handler = load_operand<const void*>(ip);      \
+        ip += sizeof(const void*);                                \
+        goto *handler;                                            \
+    } while (0)
+
+#endif
@@ -0,0 +1,147 @@
+// Benchmark độc lập cho meow_variant: so NaNBoxedVariant, FallbackVariant và std::variant trên
+// construct, copy, holds và visit. Build bằng -DMEOW_VARIANT_BUILD_BENCHMARKS=ON, chạy:
+//   ./meow_variant_bench [iterations]
+
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <string_view>
+#include <variant>
+#include <vector>
+
+#include "meow_variant.h"
+
+namespace {
+struct Object {
+    int64_t payload_ = 0;
+};
+
+// Cùng bộ kiểu với meow::Value (null, bool, int, float, con trỏ)
+template <template <typename...> class V>
+using value_of = V<std::monostate, bool, int64_t, double, Object*>;
+
+using nanbox_t = value_of<meow::utils::NaNBoxedVariant>;
+using fallback_t = value_of<meow::utils::FallbackVariant>;
+using std_t = value_of<std::variant>;
+
+template <typename T>
+inline void do_not_optimize(const T& value) noexcept {
+    asm volatile("" : : "r,m"(value) : "memory");
+}
+
+// Dãy giá trị trộn đủ các kiểu, để nhánh rẽ theo kiểu không đoán trước được hoàn toàn
+template <typename V>
+std::vector<V> make_values(size_t count, Object* object) {
+    std::vector<V> values;
+    values.reserve(count);
+    uint64_t state = 0x9E3779B97F4A7C15ull;
+    for (size_t i = 0; i < count; ++i) {
+        state ^= state << 13;
+        state ^= state >> 7;
+        state ^= state << 17;
+        switch (state % 5) {
+            case 0: values.emplace_back(std::monostate{}); break;
+            case 1: values.emplace_back((state & 1) != 0); break;
+            case 2: values.emplace_back(static_cast<int64_t>(state >> 20)); break;
+            case 3: values.emplace_back(static_cast<double>(state >> 11) * 0x1.0p-53); break;
+            default: values.emplace_back(object); break;
+        }
+    }
+    return values;
+}
+
+template <typename V, typename F>
+decltype(auto) visit_value(const V& value, F&& fn) {
+    if constexpr (std::is_same_v<V, std_t>) {
+        return std::visit(std::forward<F>(fn), value);
+    } else {
+        return value.visit(std::forward<F>(fn));
+    }
+}
+
+template <typename T, typename V>
+bool holds_value(const V& value) noexcept {
+    if constexpr (std::is_same_v<V, std_t>) {
+        return std::holds_alternative<T>(value);
+    } else {
+        return value.template holds<T>();
+    }
+}
+
+template <typename F>
+double measure_ns(size_t operations, F&& body) {
+    auto start = std::chrono::steady_clock::now();
+    body();
+    auto elapsed = std::chrono::steady_clock::now() - start;
+    return std::chrono::duration<double, std::nano>(elapsed).count() / static_cast<double>(operations);
+}
+
+template <typename V>
+void run_suite(std::string_view name, size_t iterations) {
+    constexpr size_t COUNT = 4096;
+    Object object{42};
+    const std::vector<V> values = make_values<V>(COUNT, &object);
+    const size_t operations = COUNT * iterations;
+
+    double construct = measure_ns(operations, [&] {
+        for (size_t it = 0; it < iterations; ++it) {
+            for (size_t i = 0; i < COUNT; ++i) {
+                V value(static_cast<int64_t>(i + it));
+                do_not_optimize(value);
+            }
+        }
+    });
+
+    double copy = measure_ns(operations, [&] {
+        std::vector<V> target(values);
+        for (size_t it = 0; it < iterations; ++it) {
+            for (size_t i = 0; i < COUNT; ++i) {
+                target[i] = values[(i + it) & (COUNT - 1)];
+            }
+            do_not_optimize(target.data());
+        }
+    });
+
+    double holds = measure_ns(operations, [&] {
+        size_t ints = 0;
+        for (size_t it = 0; it < iterations; ++it) {
+            for (const V& value : values) {
+                ints += holds_value<int64_t>(value);
+            }
+        }
+        do_not_optimize(ints);
+    });
+
+    // Visitor kiểu to_bool trong common/cast.h
+    double visit = measure_ns(operations, [&] {
+        size_t truthy = 0;
+        for (size_t it = 0; it < iterations; ++it) {
+            for (const V& value : values) {
+                truthy += visit_value(value, meow::overload{
+                    [](std::monostate) { return false; },
+                    [](bool b) { return b; },
+                    [](int64_t i) { return i != 0; },
+                    [](double d) { return d != 0.0; },
+                    [](Object* o) { return o != nullptr; },
+                });
+            }
+        }
+        do_not_optimize(truthy);
+    });
+
+    std::printf("%-10s %12.2f %12.2f %12.2f %12.2f\n", name.data(), construct, copy, holds, visit);
+}
+}
+
+int main(int argc, char* argv[]) {
+    size_t iterations = argc > 1 ? static_cast<size_t>(std::strtoull(argv[1], nullptr, 10)) : 2000;
+    if (iterations == 0) iterations = 1;
+
+    std::printf("sizeof: nanbox=%zu fallback=%zu std=%zu\n", sizeof(nanbox_t), sizeof(fallback_t), sizeof(std_t));
+    std::printf("%-10s %12s %12s %12s %12s   (ns/op)\n", "backend", "construct", "copy", "holds", "visit");
+    run_suite<nanbox_t>("nanbox", iterations);
+    run_suite<fallback_t>("fallback", iterations);
+    run_suite<std_t>("std", iterations);
+    return 0;
+}
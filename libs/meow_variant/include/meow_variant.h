@@ -4,6 +4,7 @@
 #include <utility>
 #include <cassert>
 #include <exception>
+#include <functional>
 
 #include "internal/nanbox.h"
 #include "internal/fallback.h"
@@ -29,7 +30,7 @@ namespace detail_backend {
     template <typename... Ts>
     struct select<utils::detail::type_list<Ts...>> {
         static constexpr bool can_nanbox = MEOW_CAN_USE_NAN_BOXING;
-        static constexpr bool small = (sizeof...(Ts) <= 8);
+        static constexpr bool small = (sizeof...(Ts) <= utils::MEOW_MAX_BOXED_TYPES);
         static constexpr bool types_ok = utils::all_nanboxable_impl<utils::detail::type_list<Ts...>>::value;
         
         using type = std::conditional_t<(can_nanbox && small && types_ok), 
@@ -46,6 +47,9 @@ class variant {
     implementation_t storage_;
 
 public:
+    // Số bit thật sự giữ được của một số nguyên (backend NaN-box chỉ có payload 48-bit)
+    static constexpr unsigned integer_bits = implementation_t::integer_bits;
+
     variant() = default;
     variant(const variant&) = default;
     variant(variant&&) = default;
@@ -72,6 +76,10 @@ public:
     template <typename T> [[nodiscard]] bool holds() const noexcept { return storage_.template holds<T>(); }
     template <typename T> [[nodiscard]] bool is() const noexcept { return holds<T>(); }
 
+    // Subtag trong con trỏ (utils::pointer_subtag_traits), chỉ hợp lệ khi holds<T>()
+    template <typename T> [[nodiscard]] uint64_t subtag() const noexcept { return storage_.template subtag<T>(); }
+    template <typename T> [[nodiscard]] bool holds_subtag(uint64_t tag) const noexcept { return storage_.template holds_subtag<T>(tag); }
+
     template <typename T> decltype(auto) get() { return storage_.template safe_get<T>(); }
     template <typename T> decltype(auto) get() const { return storage_.template safe_get<T>(); }
 
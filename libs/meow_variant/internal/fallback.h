@@ -3,6 +3,7 @@
 #include <algorithm>
 #include <array>
 #include <cstring>
+#include <functional>
 #include <memory> 
 #include <new>
 #include <stdexcept>
@@ -45,6 +46,7 @@ class FallbackVariant {
 
 public:
     using inner_types = flat_list;
+    static constexpr unsigned integer_bits = 64;
 
     FallbackVariant() noexcept : index_(npos) {}
     ~FallbackVariant() { destroy(); }
@@ -97,7 +99,7 @@ public:
     template <typename Self, typename Visitor>
     decltype(auto) visit(this Self&& self, Visitor&& vis) {
         if (self.index_ == npos) throw std::bad_variant_access();
-        return self.visit_impl(std::forward<Visitor>(vis), std::make_index_sequence<count>{});
+        return self.visit_impl(std::forward<Visitor>(vis));
     }
 
     std::size_t index() const noexcept { return static_cast<std::size_t>(index_); }
@@ -109,6 +111,16 @@ public:
         return index_ == static_cast<index_t>(idx);
     }
 
+    // Không có bit thừa để gắn subtag nên tính lại từ giá trị (xem pointer_subtag_traits)
+    template <typename T>
+    uint64_t subtag() const noexcept {
+        return pointer_subtag_traits<std::decay_t<T>>::of(*reinterpret_cast<const T*>(storage_));
+    }
+    template <typename T>
+    bool holds_subtag(uint64_t tag) const noexcept {
+        return holds<T>() && subtag<T>() == tag;
+    }
+
     template <typename T>
     T* get_if() noexcept {
         if (holds<T>()) return reinterpret_cast<T*>(storage_);
@@ -173,21 +185,26 @@ private:
         }
     }
 
-    template <typename Self, typename Visitor, std::size_t... Is>
-    decltype(auto) visit_impl(this Self&& self, Visitor&& vis, std::index_sequence<Is...>) {
-        using Ret = std::invoke_result_t<Visitor, decltype(*reinterpret_cast<typename detail::nth_type<0, flat_list>::type*>(self.storage_))>;
-        using fn_t = Ret (*)(void*, Visitor&&);
-        static constexpr std::array<fn_t, count> table = {{
-            [](void* ptr, Visitor&& v) -> Ret {
-                using T = typename detail::nth_type<Is, flat_list>::type;
-                if constexpr (std::is_const_v<std::remove_reference_t<Self>>) {
-                    return std::invoke(std::forward<Visitor>(v), *reinterpret_cast<const T*>(ptr));
-                } else {
-                    return std::invoke(std::forward<Visitor>(v), *reinterpret_cast<T*>(ptr));
-                }
-            }...
-        }};
-        return table[self.index_](const_cast<unsigned char*>(self.storage_), std::forward<Visitor>(vis));
+    // Chuỗi if constexpr theo index thay vì bảng con trỏ hàm: mỗi nhánh gọi visitor trực tiếp nên
+    // compiler inline được (và thường tự gộp chuỗi so sánh thành bảng nhảy)
+    template <std::size_t I, typename Ret, typename Self, typename Visitor>
+    static Ret visit_at(Self& self, Visitor&& vis) {
+        using T = typename detail::nth_type<I, flat_list>::type;
+        if constexpr (I + 1 < count) {
+            if (self.index_ != I) return visit_at<I + 1, Ret>(self, std::forward<Visitor>(vis));
+        }
+        if constexpr (std::is_const_v<Self>) {
+            return std::invoke(std::forward<Visitor>(vis), *reinterpret_cast<const T*>(self.storage_));
+        } else {
+            return std::invoke(std::forward<Visitor>(vis), *reinterpret_cast<T*>(self.storage_));
+        }
+    }
+
+    template <typename Self, typename Visitor>
+    decltype(auto) visit_impl(this Self&& self, Visitor&& vis) {
+        using First = typename detail::nth_type<0, flat_list>::type;
+        using Ret = std::invoke_result_t<Visitor, std::conditional_t<std::is_const_v<std::remove_reference_t<Self>>, const First&, First&>>;
+        return visit_at<0, Ret>(self, std::forward<Visitor>(vis));
     }
 };
 
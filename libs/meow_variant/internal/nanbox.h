@@ -36,16 +36,21 @@ struct all_nanboxable_impl<detail::type_list<Ts...>> {
          std::is_same_v<std::decay_t<Ts>, std::monostate> || BoolLike<Ts>)) && ...);
 };
 
-static constexpr uint64_t MEOW_EXP_MASK     = 0x7FF0000000000000ULL;
-static constexpr uint64_t MEOW_QNAN_PREFIX  = 0x7FF8000000000000ULL;
-static constexpr uint64_t MEOW_TAG_MASK     = 0x0007000000000000ULL;
-static constexpr uint64_t MEOW_PAYLOAD_MASK = 0x0000FFFFFFFFFFFFULL;
-static constexpr unsigned MEOW_TAG_SHIFT    = 48;
-static constexpr uint64_t MEOW_VALUELESS    = 0xFFFFFFFFFFFFFFFFULL;
+// Bố cục: mọi giá trị không phải double nằm trong vùng quiet NaN có bit dấu (13 bit cao đều là 1),
+// 3 bit tag ở [48, 51), payload 48 bit. Double NaN được chuẩn hoá về MEOW_CANONICAL_NAN (bit dấu 0)
+// nên không bao giờ rơi vào vùng này; ±Inf có mantissa 0 nên cũng không. Tag 7 để dành cho valueless.
+static constexpr uint64_t MEOW_BOX_PREFIX     = 0xFFF8000000000000ULL;
+static constexpr uint64_t MEOW_BOX_TAG_MASK   = 0xFFFF000000000000ULL; // prefix + tag
+static constexpr uint64_t MEOW_PAYLOAD_MASK   = 0x0000FFFFFFFFFFFFULL;
+static constexpr unsigned MEOW_TAG_SHIFT      = 48;
+static constexpr uint64_t MEOW_CANONICAL_NAN  = 0x7FF8000000000000ULL;
+static constexpr uint64_t MEOW_VALUELESS      = 0xFFFFFFFFFFFFFFFFULL;
+static constexpr std::size_t MEOW_MAX_BOXED_TYPES = 7;
 
 inline uint64_t to_bits(double d) { return std::bit_cast<uint64_t>(d); }
 inline double from_bits(uint64_t u) { return std::bit_cast<double>(u); }
-inline bool is_double(uint64_t b) { return (b & MEOW_EXP_MASK) != MEOW_EXP_MASK; }
+inline bool is_double(uint64_t b) { return (b & MEOW_BOX_PREFIX) != MEOW_BOX_PREFIX; }
+constexpr uint64_t box_tag(std::size_t idx) noexcept { return MEOW_BOX_PREFIX | (static_cast<uint64_t>(idx) << MEOW_TAG_SHIFT); }
 
 // ============================================================================
 // NaNBoxedVariant
@@ -55,14 +60,22 @@ class NaNBoxedVariant {
     using flat_list = meow::utils::flattened_unique_t<Args...>;
     static constexpr std::size_t count = detail::type_list_length<flat_list>::value;
     static constexpr std::size_t dbl_idx = detail::type_list_index_of<double, flat_list>::value;
+    static_assert(count <= MEOW_MAX_BOXED_TYPES, "NaNBoxedVariant: tag 7 is reserved for the valueless state");
+
+    template <typename T>
+    static constexpr std::size_t index_of = detail::type_list_index_of<std::decay_t<T>, flat_list>::value;
+    template <typename T>
+    static constexpr uint64_t subtag_mask = (uint64_t{1} << pointer_subtag_traits<std::decay_t<T>>::bits) - 1;
 
 public:
     using inner_types = flat_list;
     static constexpr std::size_t npos = static_cast<std::size_t>(-1);
+    // Số nguyên chỉ giữ được phần payload, sign-extend lúc decode
+    static constexpr unsigned integer_bits = MEOW_TAG_SHIFT;
 
     NaNBoxedVariant() noexcept {
         if constexpr (std::is_same_v<typename detail::nth_type<0, flat_list>::type, std::monostate>) {
-            bits_ = MEOW_QNAN_PREFIX;
+            bits_ = box_tag(0);
         } else {
             bits_ = MEOW_VALUELESS;
         }
@@ -99,12 +112,28 @@ public:
         return static_cast<std::size_t>((bits_ >> MEOW_TAG_SHIFT) & 0x7);
     }
 
+    // Bit thô, cho code cần tự so mask (vd. kiểm tra nhiều tag cùng lúc)
+    [[nodiscard]] uint64_t raw_bits() const noexcept { return bits_; }
+
     [[nodiscard]] bool valueless() const noexcept { return bits_ == MEOW_VALUELESS; }
 
+    // Một phép mask + so sánh, không rẽ nhánh theo index()
     template <typename T>
     [[nodiscard]] bool holds() const noexcept {
-        constexpr std::size_t idx = detail::type_list_index_of<std::decay_t<T>, flat_list>::value;
-        return index() == idx;
+        if constexpr (DoubleLike<std::decay_t<T>>) return is_double(bits_);
+        else return (bits_ & MEOW_BOX_TAG_MASK) == box_tag(index_of<T>);
+    }
+
+    // Subtag gắn trong các bit thấp của con trỏ (xem pointer_subtag_traits). Chỉ hợp lệ khi holds<T>()
+    template <typename T>
+    [[nodiscard]] uint64_t subtag() const noexcept {
+        return bits_ & subtag_mask<T>;
+    }
+
+    // holds<T>() && subtag<T>() == tag, gộp thành một phép mask + so sánh
+    template <typename T>
+    [[nodiscard]] bool holds_subtag(uint64_t tag) const noexcept {
+        return (bits_ & (MEOW_BOX_TAG_MASK | subtag_mask<T>)) == (box_tag(index_of<T>) | tag);
     }
 
     // --- Fix: Thêm hàm safe_get mà code cũ gọi ---
@@ -154,16 +183,22 @@ private:
     static uint64_t encode(std::size_t idx, T v) noexcept {
         using U = std::decay_t<T>;
         if constexpr (DoubleLike<U>) {
-            uint64_t b = to_bits(static_cast<double>(v));
-            if (!is_double(b)) return b; 
-            if (b == MEOW_VALUELESS) return b ^ 1;
-            return b;
+            double d = static_cast<double>(v);
+            // Mọi NaN (kể cả NaN có dấu / payload lạ) về một NaN chuẩn để không đụng vùng tag
+            if (d != d) return MEOW_CANONICAL_NAN;
+            return to_bits(d);
         } else {
             uint64_t payload = 0;
-            if constexpr (PointerLike<U>) payload = reinterpret_cast<uintptr_t>(static_cast<const void*>(v));
+            if constexpr (PointerLike<U>) {
+                using traits = pointer_subtag_traits<U>;
+                static_assert(traits::bits == 0 || alignof(std::remove_pointer_t<U>) >= (std::size_t{1} << traits::bits),
+                              "pointer_subtag_traits: pointee alignment must leave room for the subtag bits");
+                payload = reinterpret_cast<uintptr_t>(static_cast<const void*>(v));
+                if constexpr (traits::bits != 0) payload |= traits::of(v);
+            }
             else if constexpr (IntegralLike<U>) payload = static_cast<uint64_t>(static_cast<int64_t>(v));
             else if constexpr (BoolLike<U>) payload = v ? 1 : 0;
-            return MEOW_QNAN_PREFIX | (static_cast<uint64_t>(idx) << MEOW_TAG_SHIFT) | (payload & MEOW_PAYLOAD_MASK);
+            return box_tag(idx) | (payload & MEOW_PAYLOAD_MASK);
         }
     }
 
@@ -172,25 +207,35 @@ private:
         using U = std::decay_t<T>;
         if constexpr (DoubleLike<U>) return from_bits(bits);
         else if constexpr (IntegralLike<U>) return static_cast<U>(static_cast<int64_t>(bits << 16) >> 16);
-        else if constexpr (PointerLike<U>) return reinterpret_cast<U>(static_cast<uintptr_t>(bits & MEOW_PAYLOAD_MASK));
+        else if constexpr (PointerLike<U>) return reinterpret_cast<U>(static_cast<uintptr_t>(bits & MEOW_PAYLOAD_MASK & ~subtag_mask<U>));
         else if constexpr (BoolLike<U>) return static_cast<U>((bits & MEOW_PAYLOAD_MASK) != 0);
         else return U{};
     }
 
-    template <typename Visitor, std::size_t... Is>
-    decltype(auto) visit_table(Visitor&& vis, std::size_t idx, std::index_sequence<Is...>) const {
-        using R = std::invoke_result_t<Visitor, typename detail::nth_type<0, flat_list>::type>;
-        static constexpr std::array<R (*)(uint64_t, Visitor&&), count> table = {{
-            [](uint64_t b, Visitor&& v) -> R {
-                return std::forward<Visitor>(v)(decode<typename detail::nth_type<Is, flat_list>::type>(b));
-            }...
-        }};
-        return table[idx](bits_, std::forward<Visitor>(vis));
+    template <std::size_t I, typename R, typename Visitor>
+    R visit_case(Visitor&& vis) const {
+        if constexpr (I < count) {
+            return std::forward<Visitor>(vis)(decode<typename detail::nth_type<I, flat_list>::type>(bits_));
+        } else {
+            std::unreachable();
+        }
     }
 
-    template <typename Visitor>
-    decltype(auto) visit_impl(Visitor&& vis, std::size_t idx) const {
-        return visit_table(std::forward<Visitor>(vis), idx, std::make_index_sequence<count>{});
+    // Switch với case hằng thay vì bảng con trỏ hàm: mỗi nhánh gọi visitor trực tiếp nên compiler
+    // inline được cả visitor (to_bool, to_string... trong common/cast.h) và bỏ được nhánh thừa
+    template <typename Visitor, typename R = std::invoke_result_t<Visitor, typename detail::nth_type<0, flat_list>::type>>
+    R visit_impl(Visitor&& vis, std::size_t idx) const {
+        static_assert(MEOW_MAX_BOXED_TYPES == 7, "visit_impl: switch must cover every tag");
+        switch (idx) {
+            case 0: return visit_case<0, R>(std::forward<Visitor>(vis));
+            case 1: return visit_case<1, R>(std::forward<Visitor>(vis));
+            case 2: return visit_case<2, R>(std::forward<Visitor>(vis));
+            case 3: return visit_case<3, R>(std::forward<Visitor>(vis));
+            case 4: return visit_case<4, R>(std::forward<Visitor>(vis));
+            case 5: return visit_case<5, R>(std::forward<Visitor>(vis));
+            case 6: return visit_case<6, R>(std::forward<Visitor>(vis));
+            default: std::unreachable();
+        }
     }
 };
 
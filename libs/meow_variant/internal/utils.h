@@ -1,6 +1,7 @@
 #pragma once
 
 #include <cstddef>
+#include <cstdint>
 #include <type_traits>
 #include <utility>
 #include <concepts>
@@ -116,4 +117,12 @@ using flattened_unique_t = typename detail::flatten_list_implement<Ts...>::type;
 template <class... Fs> struct overload : Fs... { using Fs::operator()...; };
 template <class... Fs> overload(Fs...) -> overload<Fs...>;
 
+// Điểm mở rộng: con trỏ tới kiểu căn lề lớn có các bit thấp luôn bằng 0, nên variant có thể giữ thêm
+// một "subtag" nhỏ (vd. loại object) ngay trong đó. subtag 0 để dành cho con trỏ null.
+template <typename T>
+struct pointer_subtag_traits {
+    static constexpr unsigned bits = 0;
+    static constexpr uint64_t of(const T&) noexcept { return 0; }
+};
+
 } // namespace meow::utils
\ No newline at end of file
@@ -0,0 +1,92 @@
+#!/usr/bin/env bash
+set -uo pipefail
+
+# Chạy các test hành vi trong tests/:
+#  - tests/<name>.meow được masm dịch vào build/fast-debug/tests/ (không ghi đè file .meowb trong tests/),
+#    import giữa các test tìm module trong cùng thư mục đó
+#  - tools/gen_bytecode sinh các fixture viết tay (vd. định dạng v1) vào $OUT_DIR/gen/ từ op_codes.h hiện tại
+#  - tests/<name>.meowb là bytecode dựng sẵn, chạy thẳng
+# Mỗi dòng không rỗng trong tests/<name>.expected phải xuất hiện trong output của VM.
+
+ROOT_DIR="$(cd "$(dirname "${BASH_SOURCE[0]}")/.." && pwd)"
+cd "$ROOT_DIR"
+
+BIN_DIR="${BIN_DIR:-build/fast-debug/bin}"
+OUT_DIR="${OUT_DIR:-build/fast-debug/tests}"
+MASM="$BIN_DIR/masm"
+VM="$BIN_DIR/meow-vm"
+GEN="$BIN_DIR/gen_bytecode"
+
+if [ ! -x "$MASM" ] || [ ! -x "$VM" ] || [ ! -x "$GEN" ]; then
+    echo "masm / meow-vm / gen_bytecode not found in $BIN_DIR (run scripts/build_fast.sh first)"
+    exit 1
+fi
+mkdir -p "$OUT_DIR" "$OUT_DIR/gen"
+
+PASSED=0
+FAILED=0
+
+# check <tên test> <file .meowb> <file .expected>
+check() {
+    local name="$1" bytecode="$2" expected="$3"
+    local output status missing=""
+    output="$("$VM" "$bytecode" 2>&1)"
+    status=$?
+    while IFS= read -r line || [ -n "$line" ]; do
+        [ -z "$line" ] && continue
+        if ! grep -qF -- "$line" <<< "$output"; then
+            missing+="    missing: $line"$'\n'
+        fi
+    done < "$expected"
+
+    if [ $status -eq 0 ] && [ -z "$missing" ]; then
+        echo "PASS $name"
+        PASSED=$((PASSED + 1))
+    else
+        echo "FAIL $name (exit code $status)"
+        printf '%s' "$missing"
+        echo "$output" | tail -n 5 | sed 's/^/    > /'
+        FAILED=$((FAILED + 1))
+    fi
+}
+
+# Dịch hết trước: file không có .expected là module được test khác import (vd. modules_a.meow)
+for source in tests/*.meow; do
+    name="$(basename "$source" .meow)"
+    rm -f "$OUT_DIR/$name.meowb"
+    if ! "$MASM" "$source" "$OUT_DIR/$name.meowb" > /dev/null; then
+        echo "FAIL $name (masm)"
+        FAILED=$((FAILED + 1))
+    fi
+done
+
+for source in tests/*.meow; do
+    name="$(basename "$source" .meow)"
+    expected="tests/$name.expected"
+    bytecode="$OUT_DIR/$name.meowb"
+    [ -f "$expected" ] && [ -f "$bytecode" ] || continue
+    check "$name" "$bytecode" "$expected"
+done
+
+rm -f "$OUT_DIR"/gen/*.meowb
+if ! "$GEN" "$OUT_DIR/gen" > /dev/null; then
+    echo "FAIL gen_bytecode"
+    FAILED=$((FAILED + 1))
+fi
+for bytecode in "$OUT_DIR"/gen/*.meowb; do
+    name="$(basename "$bytecode" .meowb)"
+    expected="tests/$name.expected"
+    [ -f "$expected" ] || continue
+    check "gen/$name.meowb" "$bytecode" "$expected"
+done
+
+for bytecode in tests/*.meowb; do
+    name="$(basename "$bytecode" .meowb)"
+    expected="tests/$name.expected"
+    [ -f "$expected" ] || continue
+    check "$name.meowb" "$bytecode" "$expected"
+done
+
+echo
+echo "$PASSED passed, $FAILED failed"
+[ $FAILED -eq 0 ]
@@ -4,11 +4,18 @@
 #include "core/objects/function.h"
 #include "core/value.h"
 #include "bytecode/chunk.h"
+#include "bytecode/superinstructions.h"
+#include "bytecode/call_window.h"
+#include "bytecode/op_layout.h"
+#include "debug/print.h"
 
 namespace meow {
 
 constexpr uint32_t MAGIC_NUMBER = 0x4D454F57; // "MEOW"
-constexpr uint32_t FORMAT_VERSION = 1;
+// v2: GET_GLOBAL / SET_GLOBAL mang slot index, header có bảng tên global.
+// v1: hai lệnh đó mang index constant chứa tên, được dịch sang slot lúc load.
+constexpr uint32_t FORMAT_VERSION = 2;
+constexpr uint32_t MIN_FORMAT_VERSION = 1;
 
 enum class ConstantTag : uint8_t {
     NULL_T,
@@ -80,7 +87,7 @@ Value BinaryLoader::read_constant(size_t current_proto_idx, size_t current_const
     ConstantTag tag = static_cast<ConstantTag>(read_u8());
     switch (tag) {
         case ConstantTag::NULL_T:   return Value(null_t{});
-        case ConstantTag::INT_T:    return Value(static_cast<int64_t>(read_u64()));
+        case ConstantTag::INT_T:    return heap_->new_int(static_cast<int64_t>(read_u64()));
         case ConstantTag::FLOAT_T:  return Value(read_f64());
         case ConstantTag::STRING_T: return Value(read_string());
         
@@ -131,8 +138,19 @@ proto_t BinaryLoader::read_prototype(size_t current_proto_idx) {
     check_can_read(bytecode_size);
     std::vector<uint8_t> bytecode(data_.data() + cursor_, data_.data() + cursor_ + bytecode_size);
     cursor_ += bytecode_size;
+    check_opcodes(bytecode, name);
+    link_globals(bytecode, constants);
     
     Chunk chunk(std::move(bytecode), std::move(constants));
+    // Phân tích trên bytecode gốc, trước khi gộp superinstruction
+    chunk.set_call_window_floor(compute_call_window_floor(chunk, num_registers));
+#if defined(MEOW_ENABLE_SUPERINSTRUCTIONS)
+    size_t fused = fuse_superinstructions(chunk);
+    printl("Superinstructions: fused {} site(s) in proto '{}'", fused, name->c_str());
+#endif
+    if (!chunk.decode()) {
+        throw BinaryLoaderError(std::format("Malformed bytecode in prototype '{}'.", name->c_str()));
+    }
     return heap_->new_proto(num_registers, num_upvalues, name, std::move(chunk), std::move(upvalue_descs));
 }
 
@@ -140,9 +158,71 @@ void BinaryLoader::check_magic() {
     if (read_u32() != MAGIC_NUMBER) {
         throw BinaryLoaderError("Not a valid Meow bytecode file (magic number mismatch).");
     }
-    uint32_t version = read_u32();
-    if (version != FORMAT_VERSION) {
-        throw BinaryLoaderError(std::format("Bytecode version mismatch. File is v{}, VM supports v{}.", version, FORMAT_VERSION));
+    version_ = read_u32();
+    if (version_ < MIN_FORMAT_VERSION || version_ > FORMAT_VERSION) {
+        throw BinaryLoaderError(std::format("Bytecode version mismatch. File is v{}, VM supports v{} to v{}.", version_, MIN_FORMAT_VERSION, FORMAT_VERSION));
+    }
+}
+
+void BinaryLoader::read_global_names() {
+    if (version_ < 2) return;
+    uint32_t global_count = read_u32();
+    global_names_.reserve(global_count);
+    for (uint32_t slot = 0; slot < global_count; ++slot) {
+        string_t name = read_string();
+        if (!global_slots_.emplace(name, slot).second) {
+            throw BinaryLoaderError(std::format("Duplicate global name '{}' in global table.", name->c_str()));
+        }
+        global_names_.push_back(name);
+    }
+}
+
+uint32_t BinaryLoader::resolve_global(string_t name) {
+    auto [it, inserted] = global_slots_.emplace(name, static_cast<uint32_t>(global_names_.size()));
+    if (inserted) global_names_.push_back(name);
+    return it->second;
+}
+
+// Opcode nội bộ trong file là dấu hiệu file hỏng / giả mạo: handler của chúng bỏ qua kiểm tra kiểu
+// và superinstruction đọc cả lệnh kế tiếp. Phải kiểm tra trên byte gốc, trước fuse_superinstructions.
+void BinaryLoader::check_opcodes(const std::vector<uint8_t>& bytecode, string_t proto_name) {
+    for (size_t ip = 0; ip < bytecode.size();) {
+        if (!is_valid_opcode(bytecode[ip])) return; // Chunk::decode sẽ báo lỗi
+        OpCode op = static_cast<OpCode>(bytecode[ip]);
+        if (is_internal_opcode(op)) {
+            throw BinaryLoaderError(std::format("VM-internal opcode {} at offset {} in prototype '{}'.",
+                                                static_cast<int>(op), ip, proto_name->c_str()));
+        }
+        ip += instruction_size(op);
+    }
+}
+
+// v2: kiểm tra slot nằm trong bảng global. v1: thay index constant (tên) bằng slot, thêm tên vào bảng nếu chưa có.
+void BinaryLoader::link_globals(std::vector<uint8_t>& bytecode, const std::vector<Value>& constants) {
+    for (size_t ip = 0; ip < bytecode.size();) {
+        if (!is_valid_opcode(bytecode[ip])) return; // Chunk::decode sẽ báo lỗi
+        OpCode op = static_cast<OpCode>(bytecode[ip]);
+        size_t size = instruction_size(op);
+        if (ip + size > bytecode.size()) return;
+
+        if (op == OpCode::GET_GLOBAL || op == OpCode::SET_GLOBAL) {
+            size_t operand = ip + (op == OpCode::GET_GLOBAL ? 3 : 1);
+            uint16_t index = static_cast<uint16_t>(bytecode[operand] | (bytecode[operand + 1] << 8));
+            if (version_ < 2) {
+                if (index >= constants.size() || !constants[index].is_string()) {
+                    throw BinaryLoaderError("GET_GLOBAL/SET_GLOBAL name operand is not a string constant.");
+                }
+                uint32_t slot = resolve_global(constants[index].as_string());
+                if (slot > std::numeric_limits<uint16_t>::max()) {
+                    throw BinaryLoaderError("Too many globals in module (limit is 65536).");
+                }
+                bytecode[operand] = static_cast<uint8_t>(slot & 0xFF);
+                bytecode[operand + 1] = static_cast<uint8_t>((slot >> 8) & 0xFF);
+            } else if (index >= global_names_.size()) {
+                throw BinaryLoaderError(std::format("Global slot {} is out of range (module declares {}).", index, global_names_.size()));
+            }
+        }
+        ip += size;
     }
 }
 
@@ -176,6 +256,7 @@ void BinaryLoader::link_prototypes() {
 
 proto_t BinaryLoader::load_module() {
     check_magic();
+    read_global_names();
     
     uint32_t main_proto_index = read_u32();
     uint32_t prototype_count = read_u32();
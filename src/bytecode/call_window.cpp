@@ -0,0 +1,327 @@
+#include "bytecode/call_window.h"
+#include "bytecode/chunk.h"
+#include "bytecode/op_codes.h"
+#include "bytecode/op_layout.h"
+
+namespace meow {
+
+namespace {
+constexpr uint32_t NO_INSTRUCTION = UINT32_MAX;
+constexpr int NONE = -1;
+
+// Register mà một lệnh đọc / ghi, tính theo thứ tự các operand 'r' trong operand_layout
+struct RegisterEffect {
+    int def = NONE;          // operand bị ghi đè hoàn toàn (kill)
+    uint8_t uses = 0;        // bitmask các operand là register được đọc
+    int range_start = NONE;  // khối register liên tiếp được đọc: [regs[range_start], + regs[range_count] * range_scale)
+    int range_count = NONE;
+    size_t range_scale = 1;
+    bool reads_r0 = false;   // GET_SUPER đọc receiver ở r0
+};
+
+constexpr uint8_t operand(int index) noexcept {
+    return static_cast<uint8_t>(1u << index);
+}
+
+RegisterEffect register_effect(OpCode op, size_t reg_operands) noexcept {
+    RegisterEffect effect;
+    switch (op) {
+        case OpCode::LOAD_CONST:
+        case OpCode::LOAD_NULL:
+        case OpCode::LOAD_TRUE:
+        case OpCode::LOAD_FALSE:
+        case OpCode::LOAD_INT:
+        case OpCode::LOAD_FLOAT:
+        case OpCode::LOAD_INT_ADD:
+        case OpCode::GET_GLOBAL:
+        case OpCode::GET_UPVALUE:
+        case OpCode::NEW_CLASS:
+        case OpCode::IMPORT_MODULE:
+            effect.def = 0;
+            break;
+        case OpCode::MOVE:
+        case OpCode::MOVE_MOVE:
+        case OpCode::NEG:
+        case OpCode::NOT:
+        case OpCode::BIT_NOT:
+        case OpCode::GET_KEYS:
+        case OpCode::GET_VALUES:
+        case OpCode::NEW_INSTANCE:
+        case OpCode::GET_PROP:
+        case OpCode::GET_PROP_MOVE:
+        case OpCode::GET_EXPORT:
+            effect.def = 0;
+            effect.uses = operand(1);
+            break;
+        case OpCode::SET_GLOBAL:
+        case OpCode::SET_UPVALUE:
+        case OpCode::EXPORT:
+            effect.uses = operand(1);
+            break;
+        case OpCode::JUMP_IF_FALSE:
+        case OpCode::JUMP_IF_TRUE:
+        case OpCode::RETURN:
+        case OpCode::THROW:
+        case OpCode::IMPORT_ALL:
+        case OpCode::JEQ_I:
+        case OpCode::JNE_I:
+        case OpCode::JLT_I:
+        case OpCode::JLE_I:
+        case OpCode::JGT_I:
+        case OpCode::JGE_I:
+            effect.uses = operand(0);
+            break;
+        case OpCode::INHERIT:
+        case OpCode::JEQ:
+        case OpCode::JNE:
+        case OpCode::JLT:
+        case OpCode::JLE:
+            effect.uses = operand(0) | operand(1);
+            break;
+        case OpCode::SET_INDEX:
+            effect.uses = operand(0) | operand(1) | operand(2);
+            break;
+        case OpCode::SET_PROP:
+        case OpCode::SET_METHOD:
+            effect.uses = operand(0) | operand(2);
+            break;
+        case OpCode::GET_SUPER:
+            effect.def = 0;
+            effect.reads_r0 = true;
+            break;
+        case OpCode::CALL:
+            effect.def = 0;
+            effect.uses = operand(1);
+            effect.range_start = 2;
+            effect.range_count = 3;
+            break;
+        case OpCode::CALL_VOID:
+        case OpCode::TAIL_CALL:
+            effect.uses = operand(0);
+            effect.range_start = 1;
+            effect.range_count = 2;
+            break;
+        case OpCode::INVOKE:
+            effect.def = 0;
+            effect.uses = operand(1);
+            effect.range_start = 3;
+            effect.range_count = 4;
+            break;
+        case OpCode::NEW_ARRAY:
+            effect.def = 0;
+            effect.range_start = 1;
+            effect.range_count = 2;
+            break;
+        case OpCode::NEW_HASH:
+            effect.def = 0;
+            effect.range_start = 1;
+            effect.range_count = 2;
+            effect.range_scale = 2;
+            break;
+        case OpCode::HALT:
+        case OpCode::JUMP:
+        case OpCode::CLOSE_UPVALUES:
+        case OpCode::SETUP_TRY:
+        case OpCode::POP_TRY:
+            break;
+        default:
+            // Toán tử nhị phân (kể cả bản quickened và LT_JUMP_IF_FALSE): dst, r1, r2
+            if (reg_operands == 3) {
+                effect.def = 0;
+                effect.uses = operand(1) | operand(2);
+            } else {
+                effect.uses = static_cast<uint8_t>((1u << reg_operands) - 1);
+            }
+            break;
+    }
+    return effect;
+}
+
+constexpr bool falls_through(OpCode op) noexcept {
+    switch (op) {
+        case OpCode::JUMP:
+        case OpCode::RETURN:
+        case OpCode::HALT:
+        case OpCode::THROW:
+        case OpCode::TAIL_CALL:
+            return false;
+        default:
+            return true;
+    }
+}
+
+// TAIL_CALL cũng tính: trong constructor nó chạy như CALL thường (xem Machine::tail_call_value)
+constexpr bool is_call_site(OpCode op) noexcept {
+    return op == OpCode::CALL || op == OpCode::CALL_VOID || op == OpCode::INVOKE || op == OpCode::TAIL_CALL;
+}
+
+struct Instruction {
+    OpCode op;
+    RegisterEffect effect;
+    std::array<uint16_t, 6> regs{};
+    std::array<uint32_t, 2> successors{NO_INSTRUCTION, NO_INSTRUCTION};
+};
+
+// Tập register dạng bitset, mỗi lệnh một dải `words` phần tử trong một vector chung
+class RegisterSets {
+public:
+    RegisterSets(size_t count, size_t num_registers)
+        : words_((num_registers + 63) / 64), bits_(count * words_, 0) {}
+
+    inline uint64_t* at(size_t index) noexcept { return bits_.data() + index * words_; }
+    inline size_t words() const noexcept { return words_; }
+private:
+    size_t words_;
+    std::vector<uint64_t> bits_;
+};
+
+inline void set_bit(uint64_t* set, size_t reg) noexcept {
+    set[reg / 64] |= uint64_t{1} << (reg % 64);
+}
+inline void clear_bit(uint64_t* set, size_t reg) noexcept {
+    set[reg / 64] &= ~(uint64_t{1} << (reg % 64));
+}
+
+inline uint16_t read_u16(const uint8_t* code, size_t offset) noexcept {
+    return static_cast<uint16_t>(code[offset] | (code[offset + 1] << 8));
+}
+}
+
+size_t compute_call_window_floor(const Chunk& chunk, size_t num_registers) {
+    const uint8_t* code = chunk.get_code();
+    const size_t code_size = chunk.get_code_size();
+
+    // Pass 1: tách lệnh, đọc operand register và đích nhảy (còn ở dạng offset)
+    std::vector<Instruction> instructions;
+    std::vector<uint32_t> index_at(code_size + 1, NO_INSTRUCTION);
+    std::vector<uint32_t> catch_targets;
+    for (size_t ip = 0; ip < code_size;) {
+        if (!is_valid_opcode(code[ip])) return num_registers;
+        OpCode op = static_cast<OpCode>(code[ip]);
+        size_t size = instruction_size(op);
+        if (ip + size > code_size) return num_registers;
+        if (op == OpCode::CLOSURE) return num_registers;
+
+        Instruction& inst = instructions.emplace_back();
+        inst.op = op;
+        index_at[ip] = static_cast<uint32_t>(instructions.size() - 1);
+
+        size_t src = ip + 1;
+        size_t reg_operands = 0;
+        for (char kind : operand_layout(op)) {
+            if (kind == 'c' || kind == 'e') continue;
+            if (kind == 'q') {
+                src += 8;
+                continue;
+            }
+            uint16_t value = read_u16(code, src);
+            src += 2;
+            if (kind == 'j') {
+                inst.successors[1] = value;
+            } else if (kind == 'a') {
+                catch_targets.push_back(value);
+            } else {
+                inst.regs[reg_operands++] = value;
+            }
+        }
+        inst.effect = register_effect(op, reg_operands);
+        inst.successors[0] = falls_through(op) ? static_cast<uint32_t>(ip + size) : NO_INSTRUCTION;
+        ip += size;
+    }
+    // Nhảy tới cuối chunk rơi vào RETURN ngầm, không đọc register nào
+    const uint32_t end_index = static_cast<uint32_t>(instructions.size());
+    index_at[code_size] = end_index;
+
+    auto to_index = [&](uint32_t offset) -> uint32_t {
+        if (offset > code_size) return NO_INSTRUCTION;
+        return index_at[offset];
+    };
+    for (Instruction& inst : instructions) {
+        if (inst.successors[1] != NO_INSTRUCTION) {
+            inst.successors[1] = to_index(inst.successors[1]);
+            if (inst.successors[1] == NO_INSTRUCTION) return num_registers;
+        }
+        if (inst.successors[0] != NO_INSTRUCTION) {
+            inst.successors[0] = to_index(inst.successors[0]);
+        }
+    }
+    for (uint32_t& target : catch_targets) {
+        target = to_index(target);
+        if (target == NO_INSTRUCTION) return num_registers;
+    }
+
+    // Pass 2: liveness lùi tới điểm bất động. live_in[end_index] luôn rỗng.
+    RegisterSets live_in(instructions.size() + 1, num_registers);
+    RegisterSets scratch(2, num_registers);
+    const size_t words = live_in.words();
+    uint64_t* out = scratch.at(0);
+    uint64_t* catch_live = scratch.at(1);
+
+    auto compute_out = [&](const Instruction& inst) {
+        std::fill_n(out, words, 0);
+        for (uint32_t succ : inst.successors) {
+            if (succ == NO_INSTRUCTION) continue;
+            const uint64_t* in = live_in.at(succ);
+            for (size_t w = 0; w < words; ++w) out[w] |= in[w];
+        }
+    };
+    auto use = [&](uint64_t* set, size_t reg) {
+        if (reg < num_registers) set_bit(set, reg);
+    };
+
+    for (bool changed = true; changed;) {
+        changed = false;
+        // Lệnh nào cũng có thể ném lỗi (kể cả trong callee) và nhảy tới catch
+        std::fill_n(catch_live, words, 0);
+        for (uint32_t target : catch_targets) {
+            const uint64_t* in = live_in.at(target);
+            for (size_t w = 0; w < words; ++w) catch_live[w] |= in[w];
+        }
+
+        for (size_t i = instructions.size(); i-- > 0;) {
+            const Instruction& inst = instructions[i];
+            const RegisterEffect& effect = inst.effect;
+            compute_out(inst);
+            if (effect.def != NONE && inst.regs[effect.def] < num_registers) {
+                clear_bit(out, inst.regs[effect.def]);
+            }
+            // Sau kill: nếu lệnh ném lỗi thì dst chưa được ghi, giá trị cũ vẫn có thể được catch đọc
+            for (size_t w = 0; w < words; ++w) out[w] |= catch_live[w];
+            for (size_t k = 0; k < inst.regs.size(); ++k) {
+                if (effect.uses & operand(static_cast<int>(k))) use(out, inst.regs[k]);
+            }
+            if (effect.range_start != NONE) {
+                size_t start = inst.regs[effect.range_start];
+                size_t count = inst.regs[effect.range_count] * effect.range_scale;
+                for (size_t reg = start; reg < std::min(start + count, num_registers); ++reg) set_bit(out, reg);
+            }
+            if (effect.reads_r0) use(out, 0);
+
+            uint64_t* in = live_in.at(i);
+            if (!std::equal(out, out + words, in)) {
+                std::copy_n(out, words, in);
+                changed = true;
+            }
+        }
+    }
+
+    // Pass 3: đáy cửa sổ = register sống cao nhất sau các lời gọi, + 1
+    size_t floor = 0;
+    for (const Instruction& inst : instructions) {
+        if (!is_call_site(inst.op)) continue;
+        compute_out(inst);
+        if (inst.effect.def != NONE && inst.regs[inst.effect.def] < num_registers) {
+            clear_bit(out, inst.regs[inst.effect.def]);
+        }
+        for (size_t w = 0; w < words; ++w) out[w] |= catch_live[w];
+        for (size_t w = words; w-- > 0;) {
+            if (out[w] != 0) {
+                floor = std::max(floor, w * 64 + (63 - static_cast<size_t>(std::countl_zero(out[w]))) + 1);
+                break;
+            }
+        }
+    }
+    return floor;
+}
+
+}
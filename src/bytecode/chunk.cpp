@@ -0,0 +1,174 @@
+#include "bytecode/chunk.h"
+#include "bytecode/op_codes.h"
+#include "bytecode/op_layout.h"
+
+namespace meow {
+
+static constexpr size_t HANDLER_SLOT_SIZE = sizeof(const void*);
+
+static constexpr size_t align_to(size_t value, size_t alignment) noexcept {
+    return (value + alignment - 1) & ~(alignment - 1);
+}
+
+// Số byte (bội số của record) mà một lệnh chiếm trong stream
+static constexpr size_t decoded_size(std::string_view layout) noexcept {
+    size_t pos = HANDLER_SLOT_SIZE;
+    for (char kind : layout) {
+        switch (kind) {
+            case 'q':
+            case 'c':
+            case 'e': pos = align_to(pos, 8) + 8; break;
+            case 'a':
+            case 'j': pos = align_to(pos, 4) + 4; break;
+            default:  pos += 2; break;
+        }
+    }
+    return align_to(pos, sizeof(InstructionRecord));
+}
+
+static inline uint16_t decode_read_u16(const uint8_t* code, size_t offset) noexcept {
+    return static_cast<uint16_t>(code[offset] | (code[offset + 1] << 8));
+}
+
+static inline uint64_t decode_read_u64(const uint8_t* code, size_t offset) noexcept {
+    uint64_t value = 0;
+    for (size_t i = 0; i < 8; ++i) {
+        value |= static_cast<uint64_t>(code[offset + i]) << (i * 8);
+    }
+    return value;
+}
+
+bool Chunk::decode() {
+    const uint8_t* code = code_.data();
+    const size_t code_size = code_.size();
+
+    // Pass 1: vị trí của từng lệnh trong stream
+    std::vector<uint32_t> decoded_at(code_size + 1, UINT32_MAX);
+    size_t stream_bytes = 0;
+    for (size_t ip = 0; ip < code_size;) {
+        if (!is_valid_opcode(code[ip])) return false;
+        OpCode op = static_cast<OpCode>(code[ip]);
+        size_t size = instruction_size(op);
+        if (ip + size > code_size) return false;
+        decoded_at[ip] = static_cast<uint32_t>(stream_bytes);
+        stream_bytes += decoded_size(operand_layout(op));
+        ip += size;
+    }
+    // Cuối chunk luôn có một RETURN ngầm, để lệnh nhảy tới cuối chunk hay chạy lố vẫn an toàn
+    decoded_at[code_size] = static_cast<uint32_t>(stream_bytes);
+    stream_bytes += decoded_size(operand_layout(OpCode::RETURN));
+
+    stream_.assign(stream_bytes / sizeof(InstructionRecord), InstructionRecord{});
+    offset_map_.clear();
+    property_caches_.clear();
+    cache_sites_.clear();
+    export_caches_.clear();
+    export_sites_.clear();
+    threaded_ = false;
+    uint8_t* out = reinterpret_cast<uint8_t*>(stream_.data());
+
+    auto emit_head = [&](size_t at, OpCode op) {
+        // Trước khi thread, ô handler chứa tạm số opcode
+        uintptr_t raw = static_cast<uintptr_t>(op);
+        std::memcpy(out + at, &raw, sizeof(raw));
+    };
+
+    // Pass 2: chép operand sang vị trí đã căn lề
+    for (size_t ip = 0; ip < code_size;) {
+        OpCode op = static_cast<OpCode>(code[ip]);
+        std::string_view layout = operand_layout(op);
+        size_t start = decoded_at[ip];
+        offset_map_.emplace_back(static_cast<uint32_t>(start), static_cast<uint32_t>(ip));
+        emit_head(start, op);
+
+        size_t src = ip + 1;
+        size_t pos = HANDLER_SLOT_SIZE;
+        for (char kind : layout) {
+            if (kind == 'c') {
+                pos = align_to(pos, 8);
+                uintptr_t index = cache_sites_.size();
+                std::memcpy(out + start + pos, &index, sizeof(index));
+                cache_sites_.push_back(static_cast<uint32_t>(start + pos));
+                pos += 8;
+            } else if (kind == 'e') {
+                pos = align_to(pos, 8);
+                uintptr_t index = export_sites_.size();
+                std::memcpy(out + start + pos, &index, sizeof(index));
+                export_sites_.push_back(static_cast<uint32_t>(start + pos));
+                pos += 8;
+            } else if (kind == 'q') {
+                pos = align_to(pos, 8);
+                uint64_t value = decode_read_u64(code, src);
+                std::memcpy(out + start + pos, &value, sizeof(value));
+                pos += 8;
+                src += 8;
+            } else if (kind == 'a' || kind == 'j') {
+                uint16_t target = decode_read_u16(code, src);
+                if (target > code_size || decoded_at[target] == UINT32_MAX) return false;
+                pos = align_to(pos, 4);
+                if (kind == 'a') {
+                    // Địa chỉ tuyệt đối tính từ đầu stream
+                    uint32_t value = decoded_at[target];
+                    std::memcpy(out + start + pos, &value, sizeof(value));
+                } else {
+                    // Đích nhảy tương đối so với vị trí ngay sau operand này
+                    int32_t value = static_cast<int32_t>(decoded_at[target]) - static_cast<int32_t>(start + pos + 4);
+                    std::memcpy(out + start + pos, &value, sizeof(value));
+                }
+                pos += 4;
+                src += 2;
+            } else {
+                uint16_t value = decode_read_u16(code, src);
+                std::memcpy(out + start + pos, &value, sizeof(value));
+                pos += 2;
+                src += 2;
+            }
+        }
+        ip = src;
+    }
+
+    property_caches_.resize(cache_sites_.size());
+    export_caches_.resize(export_sites_.size());
+
+    size_t tail = decoded_at[code_size];
+    offset_map_.emplace_back(static_cast<uint32_t>(tail), static_cast<uint32_t>(code_size));
+    emit_head(tail, OpCode::RETURN);
+    uint16_t void_return = 0xFFFF;
+    std::memcpy(out + tail + HANDLER_SLOT_SIZE, &void_return, sizeof(void_return));
+
+    return true;
+}
+
+void Chunk::thread(const void* const* handlers) noexcept {
+    uint8_t* out = reinterpret_cast<uint8_t*>(stream_.data());
+    for (const auto& [decoded, source] : offset_map_) {
+        uintptr_t raw;
+        std::memcpy(&raw, out + decoded, sizeof(raw));
+        const void* handler = handlers[raw];
+        std::memcpy(out + decoded, &handler, sizeof(handler));
+    }
+    for (uint32_t site : cache_sites_) {
+        uintptr_t index;
+        std::memcpy(&index, out + site, sizeof(index));
+        PropertyCache* cache = &property_caches_[index];
+        std::memcpy(out + site, &cache, sizeof(cache));
+    }
+    for (uint32_t site : export_sites_) {
+        uintptr_t index;
+        std::memcpy(&index, out + site, sizeof(index));
+        ExportCache* cache = &export_caches_[index];
+        std::memcpy(out + site, &cache, sizeof(cache));
+    }
+    threaded_ = true;
+}
+
+size_t Chunk::source_offset(const uint8_t* ip) const noexcept {
+    if (offset_map_.empty()) return 0;
+    uint32_t decoded = static_cast<uint32_t>(ip - get_stream());
+    auto it = std::upper_bound(offset_map_.begin(), offset_map_.end(), decoded,
+                               [](uint32_t value, const auto& entry) { return value < entry.first; });
+    if (it == offset_map_.begin()) return 0;
+    return std::prev(it)->second;
+}
+
+}
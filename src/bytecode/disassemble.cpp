@@ -3,6 +3,7 @@
 #include "core/objects.h"
 #include "bytecode/op_codes.h"
 #include "core/value.h"
+#include "common/cast.h"
 #include "bytecode/chunk.h"
 
 namespace meow {
@@ -14,7 +15,11 @@ static constexpr std::array<std::string_view, static_cast<size_t>(OpCode::TOTAL_
     "JUMP",       "JUMP_IF_FALSE", "JUMP_IF_TRUE",  "CALL",       "CALL_VOID",  "RETURN",       "HALT",        "NEW_ARRAY", "NEW_HASH",
     "GET_INDEX",  "SET_INDEX",     "GET_KEYS",      "GET_VALUES", "NEW_CLASS",  "NEW_INSTANCE", "GET_PROP",    "SET_PROP",  "SET_METHOD",
     "INHERIT",    "GET_SUPER",     "BIT_AND",       "BIT_OR",     "BIT_XOR",    "BIT_NOT",      "LSHIFT",      "RSHIFT",    "THROW",
-    "SETUP_TRY",  "POP_TRY",       "IMPORT_MODULE", "EXPORT",     "GET_EXPORT", "IMPORT_ALL",
+    "SETUP_TRY",  "POP_TRY",       "IMPORT_MODULE", "EXPORT",     "GET_EXPORT", "IMPORT_ALL",   "ADD_II",      "ADD_FF",    "ADD_SS",
+    "SUB_II",     "SUB_FF",        "MUL_II",        "MUL_FF",     "DIV_FF",     "MOD_II",       "EQ_II",       "EQ_FF",     "NEQ_II",
+    "NEQ_FF",     "GT_II",         "GT_FF",         "GE_II",      "GE_FF",      "LT_II",        "LT_FF",       "LE_II",     "LE_FF",
+    "LOAD_INT_ADD", "MOVE_MOVE",   "GET_PROP_MOVE", "LT_JUMP_IF_FALSE", "JEQ",       "JNE",          "JLT",         "JLE",       "JEQ_I",
+    "JNE_I",      "JLT_I",         "JLE_I",         "JGT_I",      "JGE_I",      "TAIL_CALL",    "INVOKE",
 };
 
 inline static std::string_view opcode_to_string(OpCode op) noexcept {
@@ -60,14 +65,14 @@ std::string disassemble_chunk(const Chunk& chunk) noexcept {
     auto value_to_string = [&](const value_t& value) -> std::string {
         if (value.is_null()) return "<null>";
         if (value.is_bool()) return value.as_bool() ? "true" : "false";
-        if (value.is_int()) return std::to_string(value.as_int());
+        // Cùng định dạng với to_string (shortest round-trip, NaN / Infinity / -0.0)
+        if (value.is_int()) {
+            number_buffer_t buffer;
+            return std::string(format_int(buffer, value.as_int()));
+        }
         if (value.is_float()) {
-            std::ostringstream temp_os;
-            double r = value.as_float();
-            if (std::isnan(r)) return "NaN";
-            if (std::isinf(r)) return (r > 0) ? "Infinity" : "-Infinity";
-            temp_os << r;
-            return temp_os.str();
+            number_buffer_t buffer;
+            return std::string(format_float(buffer, value.as_float()));
         }
         if (value.is_native()) return "<native_fn>";
 
@@ -108,7 +113,8 @@ std::string disassemble_chunk(const Chunk& chunk) noexcept {
         os << std::left << std::setw(12) << op_name;
 
         switch (op) {
-            case OpCode::MOVE: {
+            case OpCode::MOVE:
+            case OpCode::MOVE_MOVE: {
                 uint16_t dst = read_u16_le(code, ip, code_size);
                 uint16_t src = read_u16_le(code, ip, code_size);
                 os << "  args=[dst=" << dst << ", src=" << src << "]";
@@ -121,7 +127,8 @@ std::string disassemble_chunk(const Chunk& chunk) noexcept {
                 os << "  args=[dst=" << dst << ", cidx=" << cidx << " -> " << val_str << "]";
                 break;
             }
-            case OpCode::LOAD_INT: {
+            case OpCode::LOAD_INT:
+            case OpCode::LOAD_INT_ADD: {
                 uint16_t dst = read_u16_le(code, ip, code_size);
                 int64_t val = read_i64_le(code, ip, code_size);
                 os << "  args=[dst=" << dst << ", val=" << val << "]";
@@ -156,7 +163,29 @@ std::string disassemble_chunk(const Chunk& chunk) noexcept {
             case OpCode::BIT_OR:
             case OpCode::BIT_XOR:
             case OpCode::LSHIFT:
-            case OpCode::RSHIFT: {
+            case OpCode::RSHIFT:
+            case OpCode::ADD_II:
+            case OpCode::ADD_FF:
+            case OpCode::ADD_SS:
+            case OpCode::SUB_II:
+            case OpCode::SUB_FF:
+            case OpCode::MUL_II:
+            case OpCode::MUL_FF:
+            case OpCode::DIV_FF:
+            case OpCode::MOD_II:
+            case OpCode::EQ_II:
+            case OpCode::EQ_FF:
+            case OpCode::NEQ_II:
+            case OpCode::NEQ_FF:
+            case OpCode::GT_II:
+            case OpCode::GT_FF:
+            case OpCode::GE_II:
+            case OpCode::GE_FF:
+            case OpCode::LT_II:
+            case OpCode::LT_FF:
+            case OpCode::LE_II:
+            case OpCode::LE_FF:
+            case OpCode::LT_JUMP_IF_FALSE: {
                 uint16_t dst = read_u16_le(code, ip, code_size);
                 uint16_t r1 = read_u16_le(code, ip, code_size);
                 uint16_t r2 = read_u16_le(code, ip, code_size);
@@ -173,16 +202,14 @@ std::string disassemble_chunk(const Chunk& chunk) noexcept {
             }
             case OpCode::GET_GLOBAL: {
                 uint16_t dst = read_u16_le(code, ip, code_size);
-                uint16_t cidx = read_u16_le(code, ip, code_size);
-                std::string name = (cidx < chunk.get_pool_size()) ? value_to_string(chunk.get_constant(cidx)) : "<bad_name>";
-                os << "  args=[dst=" << dst << ", name_idx=" << cidx << " -> " << name << "]";
+                uint16_t slot = read_u16_le(code, ip, code_size);
+                os << "  args=[dst=" << dst << ", slot=" << slot << "]";
                 break;
             }
             case OpCode::SET_GLOBAL: {
-                uint16_t name_idx = read_u16_le(code, ip, code_size);
+                uint16_t slot = read_u16_le(code, ip, code_size);
                 uint16_t src = read_u16_le(code, ip, code_size);
-                std::string name = (name_idx < chunk.get_pool_size()) ? value_to_string(chunk.get_constant(name_idx)) : "<bad_name>";
-                os << "  args=[name_idx=" << name_idx << " -> " << name << ", src=" << src << "]";
+                os << "  args=[slot=" << slot << ", src=" << src << "]";
                 break;
             }
             case OpCode::GET_UPVALUE: {
@@ -237,6 +264,28 @@ std::string disassemble_chunk(const Chunk& chunk) noexcept {
                 os << "  args=[reg=" << reg << ", target=" << target << "]";
                 break;
             }
+            case OpCode::JEQ:
+            case OpCode::JNE:
+            case OpCode::JLT:
+            case OpCode::JLE: {
+                uint16_t r1 = read_u16_le(code, ip, code_size);
+                uint16_t r2 = read_u16_le(code, ip, code_size);
+                uint16_t target = read_u16_le(code, ip, code_size);
+                os << "  args=[r1=" << r1 << ", r2=" << r2 << ", target=" << target << "]";
+                break;
+            }
+            case OpCode::JEQ_I:
+            case OpCode::JNE_I:
+            case OpCode::JLT_I:
+            case OpCode::JLE_I:
+            case OpCode::JGT_I:
+            case OpCode::JGE_I: {
+                uint16_t reg = read_u16_le(code, ip, code_size);
+                int64_t imm = read_i64_le(code, ip, code_size);
+                uint16_t target = read_u16_le(code, ip, code_size);
+                os << "  args=[reg=" << reg << ", imm=" << imm << ", target=" << target << "]";
+                break;
+            }
             case OpCode::CALL: {
                 uint16_t dst = read_u16_le(code, ip, code_size);
                 uint16_t fn_reg = read_u16_le(code, ip, code_size);
@@ -245,13 +294,24 @@ std::string disassemble_chunk(const Chunk& chunk) noexcept {
                 os << "  args=[dst=" << dst << ", fn_reg=" << fn_reg << ", arg_start=" << arg_start << ", argc=" << argc << "]";
                 break;
             }
-            case OpCode::CALL_VOID: {
+            case OpCode::CALL_VOID:
+            case OpCode::TAIL_CALL: {
                 uint16_t fn_reg = read_u16_le(code, ip, code_size);
                 uint16_t arg_start = read_u16_le(code, ip, code_size);
                 uint16_t argc = read_u16_le(code, ip, code_size);
                 os << "  args=[fn_reg=" << fn_reg << ", arg_start=" << arg_start << ", argc=" << argc << "]";
                 break;
             }
+            case OpCode::INVOKE: {
+                uint16_t dst = read_u16_le(code, ip, code_size);
+                uint16_t obj_reg = read_u16_le(code, ip, code_size);
+                uint16_t name_idx = read_u16_le(code, ip, code_size);
+                uint16_t arg_start = read_u16_le(code, ip, code_size);
+                uint16_t argc = read_u16_le(code, ip, code_size);
+                os << "  args=[dst=" << dst << ", obj_reg=" << obj_reg << ", name_idx=" << name_idx << ", arg_start=" << arg_start
+                   << ", argc=" << argc << "]";
+                break;
+            }
             case OpCode::RETURN: {
                 uint16_t ret_reg = read_u16_le(code, ip, code_size);
                 os << "  args=[ret_reg=" << ret_reg << ((ret_reg == 0xFFFF) ? " (void)" : "") << "]";
@@ -327,7 +387,8 @@ std::string disassemble_chunk(const Chunk& chunk) noexcept {
                 os << "  args=[dst=" << dst << ", class_reg=" << class_reg << "]";
                 break;
             }
-            case OpCode::GET_PROP: {
+            case OpCode::GET_PROP:
+            case OpCode::GET_PROP_MOVE: {
                 uint16_t dst = read_u16_le(code, ip, code_size);
                 uint16_t obj_reg = read_u16_le(code, ip, code_size);
                 uint16_t name_idx = read_u16_le(code, ip, code_size);
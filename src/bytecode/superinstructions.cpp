@@ -0,0 +1,57 @@
+#include "bytecode/superinstructions.h"
+#include "bytecode/chunk.h"
+#include "bytecode/op_codes.h"
+#include "bytecode/op_layout.h"
+
+namespace meow {
+
+static inline uint16_t fusion_read_u16(const uint8_t* code, size_t offset) noexcept {
+    return static_cast<uint16_t>(code[offset] | (code[offset + 1] << 8));
+}
+
+size_t fuse_superinstructions(Chunk& chunk) noexcept {
+    const uint8_t* code = chunk.get_code();
+    const size_t code_size = chunk.get_code_size();
+    size_t fused = 0;
+
+    size_t ip = 0;
+    while (ip < code_size) {
+        if (!is_valid_opcode(code[ip])) break;
+        OpCode first = static_cast<OpCode>(code[ip]);
+        size_t first_size = instruction_size(first);
+        if (ip + first_size > code_size) break;
+
+        size_t next = ip + first_size;
+        if (next >= code_size || !is_valid_opcode(code[next])) break;
+
+        OpCode second = static_cast<OpCode>(code[next]);
+        size_t second_size = instruction_size(second);
+        if (next + second_size > code_size) break;
+
+        OpCode fused_op = OpCode::TOTAL_OPCODES;
+        if (first == OpCode::LOAD_INT && second == OpCode::ADD) {
+            fused_op = OpCode::LOAD_INT_ADD;
+        } else if (first == OpCode::MOVE && second == OpCode::MOVE) {
+            fused_op = OpCode::MOVE_MOVE;
+        } else if (first == OpCode::GET_PROP && second == OpCode::MOVE) {
+            fused_op = OpCode::GET_PROP_MOVE;
+        } else if (first == OpCode::LT && second == OpCode::JUMP_IF_FALSE) {
+            // Chỉ gộp khi JUMP_IF_FALSE kiểm tra đúng register mà LT vừa ghi
+            if (fusion_read_u16(code, ip + 1) == fusion_read_u16(code, next + 1)) {
+                fused_op = OpCode::LT_JUMP_IF_FALSE;
+            }
+        }
+
+        if (fused_op != OpCode::TOTAL_OPCODES) {
+            chunk.patch_u8(ip, static_cast<uint8_t>(fused_op));
+            ++fused;
+            ip = next + second_size;
+        } else {
+            ip = next;
+        }
+    }
+
+    return fused;
+}
+
+}
@@ -23,14 +23,42 @@ void ObjClass::trace(GCVisitor& visitor) const noexcept {
         visitor.visit_object(name);
         visitor.visit_value(method);
     }
+    root_shape_->trace(visitor);
+}
+
+void ObjClass::rebuild_method_table() {
+    uint64_t chain_stamp = modified_at_;
+    if (superclass_) {
+        superclass_->refresh_method_table();
+        chain_stamp = std::max(chain_stamp, superclass_->chain_stamp_);
+    }
+    // Epoch đổi vì một class không liên quan: bảng vẫn đúng, giữ nguyên version
+    if (chain_stamp != chain_stamp_) {
+        if (superclass_) {
+            method_table_ = superclass_->method_table_;
+        } else {
+            method_table_.clear();
+        }
+        for (const auto& [name, method] : methods_) {
+            method_table_[name] = method;
+        }
+        chain_stamp_ = chain_stamp;
+        ++version_;
+    }
+    table_epoch_ = hierarchy_epoch_;
 }
 
 void ObjInstance::trace(GCVisitor& visitor) const noexcept {
     visitor.visit_object(klass_);
-    for (const auto& [key, value] : fields_) {
-        visitor.visit_object(key);
+    for (const auto& value : slots_) {
         visitor.visit_value(value);
     }
+    if (dictionary_) {
+        for (const auto& [key, value] : *dictionary_) {
+            visitor.visit_object(key);
+            visitor.visit_value(value);
+        }
+    }
 }
 
 void ObjBoundMethod::trace(GCVisitor& visitor) const noexcept {
@@ -44,6 +72,7 @@ void ObjUpvalue::trace(GCVisitor& visitor) const noexcept {
 
 void ObjFunctionProto::trace(GCVisitor& visitor) const noexcept {
     visitor.visit_object(name_);
+    visitor.visit_object(module_);
     for (size_t i = 0; i < chunk_.get_pool_size(); ++i) {
         visitor.visit_value(chunk_.get_constant(i));
     }
@@ -59,14 +88,19 @@ void ObjClosure::trace(GCVisitor& visitor) const noexcept {
 void ObjModule::trace(GCVisitor& visitor) const noexcept {
     visitor.visit_object(file_name_);
     visitor.visit_object(file_path_);
-    for (const auto& [key, value] : globals_) {
-        visitor.visit_object(key);
+    for (const auto& name : global_names_) {
+        visitor.visit_object(name);
+    }
+    for (const auto& value : global_slots_) {
         visitor.visit_value(value);
     }
-    for (const auto& [key, value] : exports_) {
-        visitor.visit_object(key);
+    for (const auto& value : export_slots_) {
         visitor.visit_value(value);
     }
+    for (const auto& [name, binding] : export_bindings_) {
+        visitor.visit_object(name);
+        visitor.visit_object(binding.owner_);
+    }
     visitor.visit_object(main_proto_);
 }
 
@@ -0,0 +1,42 @@
+#include "core/objects/shape.h"
+#include "core/objects/string.h"
+
+namespace meow {
+
+static uint32_t next_shape_id() noexcept {
+    static uint32_t counter = 0;
+    return ++counter;
+}
+
+Shape::Shape() noexcept : id_(next_shape_id()) {
+}
+
+Shape::Shape(const Shape& parent, string_t name) noexcept : id_(next_shape_id()), keys_(parent.keys_) {
+    keys_.push_back(name);
+    if (keys_.size() > LINEAR_SCAN_LIMIT) {
+        index_.reserve(keys_.size());
+        for (uint32_t slot = 0; slot < keys_.size(); ++slot) {
+            index_.try_emplace(keys_[slot], slot);
+        }
+    }
+}
+
+Shape* Shape::transition(string_t name) {
+    if (auto* child = transitions_.find(name)) {
+        return child->get();
+    }
+    if (keys_.size() >= MAX_FIELDS || transitions_.size() >= MAX_TRANSITIONS) {
+        return nullptr;
+    }
+    auto [child, inserted] = transitions_.try_emplace(name, new Shape(*this, name));
+    return child->get();
+}
+
+void Shape::trace(GCVisitor& visitor) const noexcept {
+    for (const auto& [name, child] : transitions_) {
+        visitor.visit_object(name);
+        child->trace(visitor);
+    }
+}
+
+}
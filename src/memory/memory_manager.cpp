@@ -15,13 +15,13 @@ string_t MemoryManager::new_string(std::string_view str_view) noexcept {
     }
     
     std::string s(str_view);
-    string_t new_obj = new_object<ObjString>(s);
+    string_t new_obj = new_object<ObjString>(std::string(s), next_symbol_id_++);
     string_pool_.emplace(std::move(s), new_obj);
     return new_obj;
 }
 
 string_t MemoryManager::new_string(const char* chars, size_t length) noexcept {
-    return new_string(std::string(chars, length));
+    return new_string(std::string_view(chars, length));
 }
 
 array_t MemoryManager::new_array(const std::vector<Value>& elements) noexcept {
@@ -69,4 +69,8 @@ bound_method_t MemoryManager::new_bound_method(instance_t instance, function_t f
     return new_object<ObjBoundMethod>(instance, function);
 }
 
+boxed_int_t MemoryManager::new_boxed_int(int_t value) noexcept {
+    return new_object<ObjBoxedInt>(value);
+}
+
 }
\ No newline at end of file
@@ -4,6 +4,7 @@
 #include "core/objects/module.h"
 #include "core/objects/string.h"
 #include "memory/memory_manager.h"
+#include "memory/gc_disable_guard.h"
 #include "module/module_utils.h"
 #include "vm/meow_engine.h"
 #include "bytecode/binary_loader.h"
@@ -124,10 +125,18 @@ module_t ModuleManager::load_module(string_t module_path_obj, string_t importer_
     
     file.close();
 
+    // Proto, hằng và tên global vừa nạp chỉ nằm trong loader / vector cục bộ cho tới khi module được
+    // tạo và vào module_cache_: GC không thấy chúng, nên tắt GC cho tới lúc đó (new_string / new_module
+    // ở giữa có thể kích hoạt collect)
+    GCDisableGuard gc_guard(heap_);
     proto_t main_proto = nullptr;
+    std::vector<string_t> global_names;
+    std::vector<proto_t> protos;
     try {
         BinaryLoader loader(heap_, buffer);
         main_proto = loader.load_module();
+        global_names = std::move(loader.get_global_names());
+        protos = loader.get_prototypes();
     } catch (const BinaryLoaderError& e) {
         throw std::runtime_error("Tệp bytecode bị hỏng hoặc không hợp lệ: " + 
                                  binary_file_path + " - Lỗi: " + e.what());
@@ -140,6 +149,10 @@ module_t ModuleManager::load_module(string_t module_path_obj, string_t importer_
 
     string_t filename_obj = heap_->new_string(binary_file_path_fs.filename().string());
     module_t meow_module = heap_->new_module(filename_obj, binary_file_path_obj, main_proto);
+    meow_module->define_globals(std::move(global_names));
+    for (proto_t proto : protos) {
+        proto->set_module(meow_module);
+    }
 
     // BinaryLoader loader(heap_, buffer);
     // auto load_result = loader.load();
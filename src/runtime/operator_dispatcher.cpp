@@ -1,33 +1,167 @@
 #include "runtime/operator_dispatcher.h"
 #include "memory/memory_manager.h"
-
-using namespace meow;
+#include "common/cast.h"
+#include "vm/vm_error.h"
 
 #define BINARY(opcode, type1, type2) \
-    binary_dispatch_table_[+OpCode::opcode][+ValueType::type1][+ValueType::type2] = [](MemoryManager* heap, param_t lhs, param_t rhs) -> return_t
-#define UNARY(opcode, type) unary_dispatch_table_[+OpCode::opcode][+ValueType::type] = [](MemoryManager* heap, param_t rhs) -> return_t
+    tables.binary_[+OpCode::opcode][+ValueType::type1][+ValueType::type2] = [](MemoryManager* heap [[maybe_unused]], param_t lhs, param_t rhs) -> return_t
+#define UNARY(opcode, type) tables.unary_[+OpCode::opcode][+ValueType::type] = [](MemoryManager* heap [[maybe_unused]], param_t rhs) -> return_t
+
+// Đủ 4 tổ hợp int/float: int với int giữ nguyên int, trộn kiểu thì int được nâng lên float
+#define NUMERIC_BINARY(opcode, OPERATOR) \
+    BINARY(opcode, Int, Int) { return Value(lhs.as_int() OPERATOR rhs.as_int()); }; \
+    BINARY(opcode, Int, Float) { return Value(static_cast<float_t>(lhs.as_int()) OPERATOR rhs.as_float()); }; \
+    BINARY(opcode, Float, Int) { return Value(lhs.as_float() OPERATOR static_cast<float_t>(rhs.as_int())); }; \
+    BINARY(opcode, Float, Float) { return Value(lhs.as_float() OPERATOR rhs.as_float()); }
+
+#define FLOAT_BINARY(opcode, EXPR) \
+    BINARY(opcode, Int, Float) { float_t a = static_cast<float_t>(lhs.as_int()), b = rhs.as_float(); return Value(EXPR); }; \
+    BINARY(opcode, Float, Int) { float_t a = lhs.as_float(), b = static_cast<float_t>(rhs.as_int()); return Value(EXPR); }; \
+    BINARY(opcode, Float, Float) { float_t a = lhs.as_float(), b = rhs.as_float(); return Value(EXPR); }
+
+// Int với int: tính trên đủ 64 bit, tràn int64 thì báo lỗi; kết quả ngoài small int được box (new_int)
+#define CHECKED_INT_BINARY(opcode, BUILTIN) \
+    BINARY(opcode, Int, Int) { \
+        int_t result; \
+        if (__builtin_##BUILTIN##_overflow(lhs.as_int(), rhs.as_int(), &result)) throw VMError("Integer overflow in " #opcode); \
+        return heap->new_int(result); \
+    }
+
+#define STRING_COMPARE(opcode, OPERATOR) \
+    BINARY(opcode, String, String) { return Value(string_view_of(lhs) OPERATOR string_view_of(rhs)); }
 
-OperatorDispatcher::OperatorDispatcher(MemoryManager* heap) noexcept : heap_(heap) {
-    for (size_t op_code = 0; op_code < NUM_OPCODES; ++op_code) {
-        for (size_t type1 = 0; type1 < NUM_VALUE_TYPES; ++type1) {
-            unary_dispatch_table_[op_code][type1] = nullptr;
+namespace meow {
+namespace {
+inline std::string_view string_view_of(param_t value) noexcept {
+    string_t str = value.as_string();
+    return std::string_view(str->c_str(), str->size());
+}
 
-            for (size_t type2 = 0; type2 < NUM_VALUE_TYPES; ++type2) {
-                binary_dispatch_table_[op_code][type1][type2] = nullptr;
-            }
+// So sánh đồng nhất cho mọi cặp kiểu không phải số: khác kiểu là khác nhau, object so theo địa chỉ
+// (chuỗi đã intern nên cùng nội dung thì cùng địa chỉ)
+inline bool values_identical(param_t lhs, param_t rhs) noexcept {
+    if (lhs.index() != rhs.index()) return false;
+    if (lhs.is_null()) return true;
+    if (lhs.is_bool()) return lhs.as_bool() == rhs.as_bool();
+    if (lhs.is_int()) return rhs.is_int() && lhs.as_int() == rhs.as_int(); // int đã box cũng mang index Object
+    if (lhs.is_float()) return lhs.as_float() == rhs.as_float();
+    if (lhs.is_native()) return lhs.as_native() == rhs.as_native();
+    return lhs.as_object() == rhs.as_object();
+}
+
+// Trả về false nếu kết quả tràn int64 (exponent >= 0)
+inline bool int_pow(int_t base, int_t exponent, int_t& out) noexcept {
+    int_t result = 1;
+    int_t factor = base;
+    bool factor_overflow = false;
+    for (int_t e = exponent; e != 0; e >>= 1) {
+        if (e & 1) {
+            if (factor_overflow || __builtin_mul_overflow(result, factor, &result)) return false;
         }
+        if (e > 1 && !factor_overflow) factor_overflow = __builtin_mul_overflow(factor, factor, &factor);
     }
+    out = result;
+    return true;
+}
 
-    using enum OpCode;
-    using enum ValueType;
+constexpr OperatorTables build_operator_tables() noexcept {
+    OperatorTables tables{};
 
-    binary_dispatch_table_[+ADD][+Int][+Int] = [](MemoryManager*, param_t lhs, param_t rhs) -> return_t { return Value(lhs.as_int() + rhs.as_int()); };
+    // --- Arithmetic ---
+    CHECKED_INT_BINARY(ADD, add);
+    CHECKED_INT_BINARY(SUB, sub);
+    CHECKED_INT_BINARY(MUL, mul);
+    FLOAT_BINARY(ADD, a + b);
+    FLOAT_BINARY(SUB, a - b);
+    FLOAT_BINARY(MUL, a * b);
+    BINARY(ADD, String, String) {
+        string_t a = lhs.as_string();
+        string_t b = rhs.as_string();
+        std::string joined;
+        joined.reserve(a->size() + b->size());
+        joined.append(a->c_str(), a->size()).append(b->c_str(), b->size());
+        return Value(heap->new_string(joined));
+    };
 
-    BINARY(ADD, Float, Float) {
-        return Value(lhs.as_float() + rhs.as_float());
+    BINARY(DIV, Int, Int) {
+        if (rhs.as_int() == 0) throw VMError("Division by zero in DIV");
+        int_t result;
+        if (rhs.as_int() == -1) {
+            if (__builtin_sub_overflow(int_t{0}, lhs.as_int(), &result)) throw VMError("Integer overflow in DIV");
+            return heap->new_int(result);
+        }
+        return heap->new_int(lhs.as_int() / rhs.as_int());
     };
+    FLOAT_BINARY(DIV, a / b);
 
-    BINARY(ADD, String, String) {
-        return Value(heap->new_string(std::string(lhs.as_string()->c_str()) + rhs.as_string()->c_str()));
+    BINARY(MOD, Int, Int) {
+        if (rhs.as_int() == 0) throw VMError("Division by zero in MOD");
+        if (rhs.as_int() == -1) return Value::small_int(0);
+        return heap->new_int(lhs.as_int() % rhs.as_int());
     };
-}
\ No newline at end of file
+    FLOAT_BINARY(MOD, std::fmod(a, b));
+
+    // Số mũ âm cho kết quả không nguyên nên đi đường float
+    BINARY(POW, Int, Int) {
+        if (rhs.as_int() < 0) return Value(std::pow(static_cast<float_t>(lhs.as_int()), static_cast<float_t>(rhs.as_int())));
+        int_t result;
+        if (!int_pow(lhs.as_int(), rhs.as_int(), result)) throw VMError("Integer overflow in POW");
+        return heap->new_int(result);
+    };
+    FLOAT_BINARY(POW, std::pow(a, b));
+
+    // --- Comparisons ---
+    for (size_t lhs_type = 0; lhs_type < NUM_VALUE_TYPES; ++lhs_type) {
+        for (size_t rhs_type = 0; rhs_type < NUM_VALUE_TYPES; ++rhs_type) {
+            tables.binary_[+OpCode::EQ][lhs_type][rhs_type] = [](MemoryManager*, param_t lhs, param_t rhs) -> return_t {
+                return Value(values_identical(lhs, rhs));
+            };
+            tables.binary_[+OpCode::NEQ][lhs_type][rhs_type] = [](MemoryManager*, param_t lhs, param_t rhs) -> return_t {
+                return Value(!values_identical(lhs, rhs));
+            };
+        }
+    }
+    NUMERIC_BINARY(EQ, ==);
+    NUMERIC_BINARY(NEQ, !=);
+    NUMERIC_BINARY(GT, >);
+    NUMERIC_BINARY(GE, >=);
+    NUMERIC_BINARY(LT, <);
+    NUMERIC_BINARY(LE, <=);
+    STRING_COMPARE(GT, >);
+    STRING_COMPARE(GE, >=);
+    STRING_COMPARE(LT, <);
+    STRING_COMPARE(LE, <=);
+
+    // --- Bitwise ---
+    BINARY(BIT_AND, Int, Int) { return heap->new_int(lhs.as_int() & rhs.as_int()); };
+    BINARY(BIT_OR, Int, Int) { return heap->new_int(lhs.as_int() | rhs.as_int()); };
+    BINARY(BIT_XOR, Int, Int) { return heap->new_int(lhs.as_int() ^ rhs.as_int()); };
+    BINARY(BIT_AND, Bool, Bool) { return Value(lhs.as_bool() && rhs.as_bool()); };
+    BINARY(BIT_OR, Bool, Bool) { return Value(lhs.as_bool() || rhs.as_bool()); };
+    BINARY(BIT_XOR, Bool, Bool) { return Value(lhs.as_bool() != rhs.as_bool()); };
+    // Số bit dịch được lấy modulo 64 như phần cứng, tránh UB của C++
+    BINARY(LSHIFT, Int, Int) {
+        return heap->new_int(static_cast<int_t>(static_cast<uint64_t>(lhs.as_int()) << (rhs.as_int() & 63)));
+    };
+    BINARY(RSHIFT, Int, Int) { return heap->new_int(lhs.as_int() >> (rhs.as_int() & 63)); };
+
+    // --- Unary ---
+    UNARY(NEG, Int) {
+        int_t result;
+        if (__builtin_sub_overflow(int_t{0}, rhs.as_int(), &result)) throw VMError("Integer overflow in NEG");
+        return heap->new_int(result);
+    };
+    UNARY(NEG, Float) { return Value(-rhs.as_float()); };
+    UNARY(BIT_NOT, Int) { return heap->new_int(~rhs.as_int()); };
+    UNARY(NOT, Bool) { return Value(!rhs.as_bool()); };
+    for (size_t type = 0; type < NUM_VALUE_TYPES; ++type) {
+        if (type == +ValueType::Bool) continue;
+        tables.unary_[+OpCode::NOT][type] = [](MemoryManager*, param_t rhs) -> return_t { return Value(!to_bool(rhs)); };
+    }
+
+    return tables;
+}
+}
+
+constexpr OperatorTables OPERATOR_TABLES = build_operator_tables();
+}
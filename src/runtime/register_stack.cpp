@@ -0,0 +1,70 @@
+#include "runtime/register_stack.h"
+#include "vm/vm_error.h"
+
+#if defined(_WIN32)
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#else
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+using namespace meow;
+
+namespace {
+// Commit theo khối lớn để không phải gọi vào kernel ở mỗi CALL sâu hơn một chút
+constexpr size_t COMMIT_CHUNK_BYTES = 64 * 1024;
+
+size_t page_size() noexcept {
+#if defined(_WIN32)
+    SYSTEM_INFO info;
+    GetSystemInfo(&info);
+    return static_cast<size_t>(info.dwAllocationGranularity);
+#else
+    return static_cast<size_t>(sysconf(_SC_PAGESIZE));
+#endif
+}
+
+size_t round_up(size_t value, size_t alignment) noexcept {
+    return (value + alignment - 1) / alignment * alignment;
+}
+}
+
+RegisterStack::RegisterStack(size_t limit) : limit_(limit) {
+    reserved_bytes_ = round_up(std::max<size_t>(limit_, 1) * sizeof(Value), std::max(page_size(), COMMIT_CHUNK_BYTES));
+#if defined(_WIN32)
+    void* memory = VirtualAlloc(nullptr, reserved_bytes_, MEM_RESERVE, PAGE_NOACCESS);
+    if (memory == nullptr) throw std::bad_alloc();
+#else
+    void* memory = mmap(nullptr, reserved_bytes_, PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+    if (memory == MAP_FAILED) throw std::bad_alloc();
+#endif
+    base_ = static_cast<Value*>(memory);
+}
+
+RegisterStack::~RegisterStack() noexcept {
+    if (base_ == nullptr) return;
+#if defined(_WIN32)
+    VirtualFree(base_, 0, MEM_RELEASE);
+#else
+    munmap(base_, reserved_bytes_);
+#endif
+}
+
+void RegisterStack::throw_overflow() const {
+    throw VMError(std::format("Stack overflow: register stack limit of {} slots exceeded.", limit_));
+}
+
+void RegisterStack::commit(size_t new_size) {
+    size_t committed_bytes = committed_ * sizeof(Value);
+    size_t target_bytes = std::min(round_up(new_size * sizeof(Value), COMMIT_CHUNK_BYTES), reserved_bytes_);
+    void* start = reinterpret_cast<uint8_t*>(base_) + committed_bytes;
+    size_t length = target_bytes - committed_bytes;
+
+#if defined(_WIN32)
+    if (VirtualAlloc(start, length, MEM_COMMIT, PAGE_READWRITE) == nullptr) throw std::bad_alloc();
+#else
+    if (mprotect(start, length, PROT_READ | PROT_WRITE) != 0) throw std::bad_alloc();
+#endif
+    committed_ = target_bytes / sizeof(Value);
+}
@@ -0,0 +1,280 @@
+#pragma once
+// Chứa các helper cho Call, Return (dùng chung giữa các lệnh gọi hàm)
+
+inline void Machine::call_value(size_t ret_reg, uint16_t fn_reg, uint16_t arg_start, uint16_t argc) {
+    call_callee(context_->registers_[context_->current_base_ + fn_reg], ret_reg, fn_reg, arg_start, argc);
+}
+
+// Gọi một giá trị bất kỳ; fn_reg là slot dành cho self nếu callee là bound method / class
+inline void Machine::call_callee(Value callee, size_t ret_reg, uint16_t fn_reg, uint16_t arg_start, uint16_t argc) {
+    size_t caller_base = context_->current_base_;
+
+    if (callee.is_native()) {
+        native_t fn = callee.as_native();
+        Value* args_ptr = context_->registers_.data() + caller_base + arg_start;
+        Value result = fn(this, argc, args_ptr);
+        if (ret_reg != static_cast<size_t>(-1)) {
+            context_->registers_[context_->current_base_ + ret_reg] = result;
+        }
+        return;
+    }
+
+    instance_t self = nullptr;
+    function_t closure_to_call = nullptr;
+    bool is_constructor_call = false;
+
+    if (callee.is_function()) {
+        closure_to_call = callee.as_function();
+    } else if (callee.is_bound_method()) {
+        bound_method_t bound = callee.as_bound_method();
+        self = bound->get_instance();
+        closure_to_call = bound->get_function();
+    } else if (callee.is_class()) {
+        class_t k = callee.as_class();
+        self = heap_->new_instance(k);
+        is_constructor_call = true;
+        if (ret_reg != static_cast<size_t>(-1)) {
+            context_->registers_[caller_base + ret_reg] = Value(self);
+        }
+        Value init_val = k->get_initializer();
+        if (init_val.is_function()) {
+            closure_to_call = init_val.as_function();
+        } else {
+            return;
+        }
+    } else {
+        throw_vm_error("CALL: Giá trị không thể gọi được.");
+    }
+
+    if (closure_to_call == nullptr) {
+        return;
+    }
+
+    push_frame(ret_reg, closure_to_call, self, fn_reg, arg_start, argc, is_constructor_call);
+}
+
+// Quy ước gọi hàm (giống Lua): khi được, cửa sổ register của callee đặt chồng lên khối args của caller,
+// nên args đã nằm sẵn ở r0..r(argc-1) của callee mà không phải copy. Với bound method / constructor,
+// self được ghi vào slot ngay trước args (self_reg khi self_reg == arg_start - 1) và cửa sổ bắt đầu từ đó.
+// Chỉ chồng khi loader đã chứng minh không register nào từ chỗ bắt đầu cửa sổ trở lên của caller còn
+// được đọc sau lời gọi (đáy cửa sổ, xem bytecode/call_window.h); nếu không thì dựng cửa sổ mới ở đỉnh
+// stack và copy args như cũ. Nhờ vậy upvalue đang mở của caller luôn nằm dưới base của callee.
+inline void Machine::push_frame(size_t ret_reg, function_t closure, instance_t self, uint16_t self_reg, uint16_t arg_start,
+                                uint16_t argc, bool is_constructor_call) {
+    size_t caller_base = context_->current_base_;
+    size_t window_floor = context_->current_frame_->proto_->get_chunk().get_call_window_floor();
+    proto_t proto = closure->get_proto();
+    size_t num_registers = proto->get_num_registers();
+    size_t args_base = caller_base + arg_start;
+    size_t num_args = argc + (self != nullptr ? 1 : 0);
+    size_t new_base;
+
+    if (self == nullptr && arg_start >= window_floor) {
+        new_base = args_base;
+    } else if (self != nullptr && self_reg + 1 == arg_start && self_reg >= window_floor) {
+        new_base = args_base - 1;
+        context_->registers_[new_base] = Value(self);
+    } else {
+        // Không chồng được: dựng cửa sổ mới ở đỉnh stack
+        new_base = context_->registers_.size();
+        context_->registers_.resize(new_base + std::max(num_registers, num_args));
+        Value* window = context_->registers_.data() + new_base;
+        if (self != nullptr) {
+            *window++ = Value(self);
+        }
+        std::copy_n(context_->registers_.data() + args_base, argc, window);
+    }
+
+    open_window(new_base, num_args, num_registers);
+
+    // Slot global trong chunk thuộc về module định nghĩa hàm, không phải module của caller
+    module_t current_module = proto->get_module() ? proto->get_module() : context_->current_frame_->module_;
+    context_->current_frame_ = &context_->call_stack_.emplace_back(closure, current_module, new_base, ret_reg,
+                                                                   is_constructor_call ? self : nullptr);
+    context_->current_base_ = new_base;
+}
+
+// INVOKE: tra method rồi push frame với self = obj, bỏ qua ObjBoundMethod mà GET_PROP + CALL phải cấp phát.
+// Thứ tự tra cứu giống GET_PROP: field của instance trước (gọi như giá trị thường), rồi tới method của class.
+inline void Machine::invoke_method(size_t ret_reg, uint16_t obj_reg, string_t name, uint16_t arg_start, uint16_t argc,
+                                   PropertyCache* cache) {
+    Value obj = context_->registers_[context_->current_base_ + obj_reg];
+
+    if (obj.is_instance()) [[likely]] {
+        instance_t inst = obj.as_instance();
+        const Shape* shape = inst->get_shape();
+        if (shape) {
+            if (const PropertyCacheEntry* entry = cache->lookup(shape->get_id())) {
+                if (entry->slot_ != Shape::NOT_FOUND) {
+                    call_callee(inst->get_slot(entry->slot_), ret_reg, obj_reg, arg_start, argc);
+                    return;
+                }
+                if (entry->version_ == inst->get_class()->get_method_version()) {
+                    push_frame(ret_reg, entry->method_.as_function(), inst, obj_reg, arg_start, argc, false);
+                    return;
+                }
+            }
+        }
+
+        if (PropertyCacheEntry found; resolve_property(inst, name, cache, found)) {
+            if (found.slot_ != Shape::NOT_FOUND) {
+                call_callee(inst->get_slot(found.slot_), ret_reg, obj_reg, arg_start, argc);
+            } else {
+                push_frame(ret_reg, found.method_.as_function(), inst, obj_reg, arg_start, argc, false);
+            }
+            return;
+        }
+        // Dictionary mode: không có shape để cache nên tra thẳng bảng băm
+        if (Value* field = inst->find_field(name)) {
+            call_callee(*field, ret_reg, obj_reg, arg_start, argc);
+            return;
+        }
+        if (class_t k = inst->get_class()) {
+            if (const Value* method = k->find_method(name)) {
+                push_frame(ret_reg, method->as_function(), inst, obj_reg, arg_start, argc, false);
+                return;
+            }
+        }
+        throw_vm_error("INVOKE: Instance không có method tên là '" + std::string(name->c_str()) + "'.");
+    }
+
+    if (obj.is_module()) {
+        module_t mod = obj.as_module();
+        if (const auto* binding = mod->find_export(name)) {
+            call_callee(binding->owner_->get_export_slot(binding->slot_), ret_reg, obj_reg, arg_start, argc);
+            return;
+        }
+        throw_vm_error("INVOKE: Module không export '" + std::string(name->c_str()) + "'.");
+    }
+
+    throw_vm_error("INVOKE: Chỉ gọi được method trên instance hoặc module.");
+}
+
+// Chuẩn bị cửa sổ [new_base, new_base + num_registers): args giữ nguyên, các slot còn lại về null.
+// Phần nằm trên đỉnh stack được resize đặt về null; phần chồng lên caller thì tự xoá.
+inline void Machine::open_window(size_t new_base, size_t num_args, size_t num_registers) {
+    size_t window_end = new_base + num_registers;
+    size_t old_top = context_->registers_.size();
+    if (window_end > old_top) {
+        context_->registers_.resize(window_end);
+    }
+    Value* window = context_->registers_.data();
+    for (size_t i = new_base + num_args; i < std::min(window_end, old_top); ++i) {
+        window[i] = Value(null_t{});
+    }
+}
+
+// TAIL_CALL: callee thay chỗ frame hiện tại (cùng CallFrame, cùng base, cùng ret_reg) nên đệ quy đuôi
+// chạy trong stack hằng. Trả về false nếu VM dừng (native / constructor rỗng trả về từ frame cuối).
+inline bool Machine::tail_call_value(uint16_t fn_reg, uint16_t arg_start, uint16_t argc) {
+    CallFrame* frame = context_->current_frame_;
+    size_t base = context_->current_base_;
+    Value callee = context_->registers_[base + fn_reg];
+
+    // Frame của constructor phải trả về instance đang dựng nên không thể bị thay: gọi bình thường rồi
+    // quay về RETURN sentinel ở cuối stream, return_from_frame sẽ trả constructed_
+    if (frame->constructed_) {
+        const Chunk& chunk = frame->proto_->get_chunk();
+        frame->ip_ = chunk.get_stream() + chunk.get_stream_size() - sizeof(InstructionRecord);
+        call_value(static_cast<size_t>(-1), fn_reg, arg_start, argc);
+        return true;
+    }
+
+    if (callee.is_native()) {
+        native_t fn = callee.as_native();
+        Value result = fn(this, argc, context_->registers_.data() + base + arg_start);
+        return return_from_frame(result);
+    }
+
+    instance_t self = nullptr;
+    function_t closure_to_call = nullptr;
+    bool is_constructor_call = false;
+
+    if (callee.is_function()) {
+        closure_to_call = callee.as_function();
+    } else if (callee.is_bound_method()) {
+        bound_method_t bound = callee.as_bound_method();
+        self = bound->get_instance();
+        closure_to_call = bound->get_function();
+    } else if (callee.is_class()) {
+        class_t k = callee.as_class();
+        self = heap_->new_instance(k);
+        is_constructor_call = true;
+        Value init_val = k->get_initializer();
+        if (!init_val.is_function()) {
+            return return_from_frame(Value(self));
+        }
+        closure_to_call = init_val.as_function();
+    } else {
+        throw_vm_error("TAIL_CALL: Giá trị không thể gọi được.");
+    }
+
+    // Frame đi ra kết thúc tại đây: đóng upvalue, bỏ các try còn mở của nó, đánh dấu module đã chạy xong
+    close_upvalues(context_.get(), base);
+    size_t frame_depth = context_->call_stack_.size() - 1;
+    while (!context_->exception_handlers_.empty() && context_->exception_handlers_.back().frame_depth_ >= frame_depth) {
+        context_->exception_handlers_.pop_back();
+    }
+    if (frame->proto_ == frame->module_->get_main_proto() && frame->module_->is_executing()) {
+        frame->module_->set_executed();
+    }
+
+    // Dời self + args xuống base của frame hiện tại (có thể chồng nhau nên chọn chiều copy)
+    Value* window = context_->registers_.data();
+    Value* src = window + base + arg_start;
+    Value* dst = window + base + (self != nullptr ? 1 : 0);
+    if (dst <= src) {
+        std::copy(src, src + argc, dst);
+    } else {
+        std::copy_backward(src, src + argc, dst + argc);
+    }
+    if (self != nullptr) {
+        window[base] = Value(self);
+    }
+
+    proto_t proto = closure_to_call->get_proto();
+    size_t num_args = argc + (self != nullptr ? 1 : 0);
+    context_->registers_.resize(std::min(context_->registers_.size(), base + num_args));
+    open_window(base, num_args, proto->get_num_registers());
+
+    module_t module = proto->get_module() ? proto->get_module() : frame->module_;
+    size_t ret_reg = frame->ret_reg_;
+    std::construct_at(frame, closure_to_call, module, base, ret_reg, is_constructor_call ? self : nullptr);
+    return true;
+}
+
+inline bool Machine::return_from_frame(Value return_value) {
+    // Frame không bị dời khi pop, chỉ cần giữ con trỏ thay vì copy cả frame
+    const CallFrame* popped_frame = context_->current_frame_;
+    size_t old_base = popped_frame->start_reg_;
+    size_t ret_reg = popped_frame->ret_reg_;
+    if (instance_t self = popped_frame->constructed_) {
+        return_value = Value(self);
+        // init vừa chạy xong: ghi nhớ số field để lần sau cấp phát trước slot cho instance mới
+        if (class_t k = self->get_class()) k->record_field_count(self->field_count());
+    }
+    // Chỉ upvalue mở trong cửa sổ của chính frame này (>= base của nó): của caller luôn nằm thấp hơn
+    close_upvalues(context_.get(), old_base);
+    if (popped_frame->proto_ == popped_frame->module_->get_main_proto()) {
+        if (popped_frame->module_->is_executing()) {
+            popped_frame->module_->set_executed();
+        }
+    }
+    context_->call_stack_.pop_back();
+
+    if (context_->call_stack_.empty()) {
+        printl("Call stack empty. Halting.");
+        if (!context_->registers_.empty()) context_->registers_[0] = return_value;
+        return false;
+    }
+
+    context_->current_frame_ = &context_->call_stack_.back();
+    context_->current_base_ = context_->current_frame_->start_reg_;
+    // Cửa sổ callee có thể nằm chồng trong cửa sổ caller: đưa đỉnh stack về đúng cuối cửa sổ caller
+    // (trước khi ghi kết quả, vì phần mở rộng lại được đặt về null)
+    context_->registers_.resize(context_->current_base_ + context_->current_frame_->proto_->get_num_registers());
+    if (ret_reg != static_cast<size_t>(-1)) {
+        context_->registers_[context_->current_base_ + ret_reg] = return_value;
+    }
+    return true;
+}
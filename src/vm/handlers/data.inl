@@ -1,7 +1,7 @@
 #pragma once
 // Chứa các handler cho Array, Hash, Index
 
-inline void Machine::op_new_array(const uint8_t*& ip) {
+inline void Machine::op_new_array(const uint8_t*& ip, Value* regs, const Value* constants) {
     uint16_t dst = READ_U16();
     uint16_t start_idx = READ_U16();
     uint16_t count = READ_U16();
@@ -15,7 +15,7 @@ inline void Machine::op_new_array(const uint8_t*& ip) {
     printl("is_array(): {}", REGISTER(dst).is_array());
 }
 
-inline void Machine::op_new_hash(const uint8_t*& ip) {
+inline void Machine::op_new_hash(const uint8_t*& ip, Value* regs, const Value* constants) {
     uint16_t dst = READ_U16();
     uint16_t start_idx = READ_U16();
     uint16_t count = READ_U16();
@@ -31,7 +31,7 @@ inline void Machine::op_new_hash(const uint8_t*& ip) {
     REGISTER(dst) = Value(hash_table);
 }
 
-inline void Machine::op_get_index(const uint8_t*& ip) {
+inline void Machine::op_get_index(const uint8_t*& ip, Value* regs, const Value* constants) {
     uint16_t dst = READ_U16();
     uint16_t src_reg = READ_U16();
     uint16_t key_reg = READ_U16();
@@ -66,7 +66,7 @@ inline void Machine::op_get_index(const uint8_t*& ip) {
     }
 }
 
-inline void Machine::op_set_index(const uint8_t*& ip) {
+inline void Machine::op_set_index(const uint8_t*& ip, Value* regs, const Value* constants) {
     uint16_t src_reg = READ_U16();
     uint16_t key_reg = READ_U16();
     uint16_t val_reg = READ_U16();
@@ -91,7 +91,7 @@ inline void Machine::op_set_index(const uint8_t*& ip) {
     }
 }
 
-inline void Machine::op_get_keys(const uint8_t*& ip) {
+inline void Machine::op_get_keys(const uint8_t*& ip, Value* regs, const Value* constants) {
     uint16_t dst = READ_U16();
     uint16_t src_reg = READ_U16();
     Value& src = REGISTER(src_reg);
@@ -106,20 +106,21 @@ inline void Machine::op_get_keys(const uint8_t*& ip) {
     else if (src.is_array()) {
         array_t arr = src.as_array();
         keys_array->reserve(arr->size());
+        // Index luôn vừa small int trong thực tế nên new_int không cấp phát, nhưng không giả định điều đó
         for (size_t i = 0; i < arr->size(); ++i) {
-            keys_array->push(Value(static_cast<int64_t>(i)));
+            keys_array->push(heap_->new_int(static_cast<int_t>(i)));
         }
     } else if (src.is_string()) {
         string_t str = src.as_string();
         keys_array->reserve(str->size());
         for (size_t i = 0; i < str->size(); ++i) {
-            keys_array->push(Value(static_cast<int64_t>(i)));
+            keys_array->push(heap_->new_int(static_cast<int_t>(i)));
         }
     }
     REGISTER(dst) = Value(keys_array);
 }
 
-inline void Machine::op_get_values(const uint8_t*& ip) {
+inline void Machine::op_get_values(const uint8_t*& ip, Value* regs, const Value* constants) {
     uint16_t dst = READ_U16();
     uint16_t src_reg = READ_U16();
     Value& src = REGISTER(src_reg);
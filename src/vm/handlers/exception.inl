@@ -1,7 +1,7 @@
 #pragma once
 
-inline void Machine::op_setup_try(const uint8_t*& ip) {
-    uint16_t target = READ_ADDRESS(); // Địa chỉ nhảy tới catch
+inline void Machine::op_setup_try(const uint8_t*& ip, Value* regs, const Value* constants) {
+    uint32_t target = READ_ADDRESS(); // Địa chỉ nhảy tới catch (offset trong stream)
     uint16_t err_reg = READ_U16();    //  Register lưu lỗi
 
     size_t catch_ip = target;
@@ -22,7 +22,7 @@ inline void Machine::op_pop_try() {
     }
 }
 
-inline void Machine::op_throw(const uint8_t*& ip) {
+inline void Machine::op_throw(const uint8_t*& ip, Value* regs, const Value* constants) {
     uint16_t reg = READ_U16();
     Value& val = REGISTER(reg);
     // Ném lỗi với message từ register
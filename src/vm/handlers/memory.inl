@@ -1,27 +1,20 @@
 #pragma once
 // Chứa các handler cho Global, Upvalue, Closure
 
-inline void Machine::op_get_global(const uint8_t*& ip) {
+// Slot đã được BinaryLoader kiểm tra (hoặc dịch từ tên ở bytecode v1) nên truy cập thẳng
+inline void Machine::op_get_global(const uint8_t*& ip, Value* regs, const Value* constants) {
     uint16_t dst = READ_U16();
-    uint16_t name_idx = READ_U16();
-    string_t name = CONSTANT(name_idx).as_string();
-    module_t module = context_->current_frame_->module_;
-    if (module->has_global(name)) {
-        REGISTER(dst) = module->get_global(name);
-    } else {
-        REGISTER(dst) = Value(null_t{});
-    }
+    uint16_t slot = READ_U16();
+    REGISTER(dst) = context_->current_frame_->module_->get_global_slot(slot);
 }
 
-inline void Machine::op_set_global(const uint8_t*& ip) {
-    uint16_t name_idx = READ_U16();
+inline void Machine::op_set_global(const uint8_t*& ip, Value* regs, const Value* constants) {
+    uint16_t slot = READ_U16();
     uint16_t src = READ_U16();
-    string_t name = CONSTANT(name_idx).as_string();
-    module_t module = context_->current_frame_->module_;
-    module->set_global(name, REGISTER(src));
+    context_->current_frame_->module_->set_global_slot(slot, REGISTER(src));
 }
 
-inline void Machine::op_get_upvalue(const uint8_t*& ip) {
+inline void Machine::op_get_upvalue(const uint8_t*& ip, Value* regs, const Value* constants) {
     uint16_t dst = READ_U16();
     uint16_t uv_idx = READ_U16();
     upvalue_t uv = context_->current_frame_->function_->get_upvalue(uv_idx);
@@ -32,7 +25,7 @@ inline void Machine::op_get_upvalue(const uint8_t*& ip) {
     }
 }
 
-inline void Machine::op_set_upvalue(const uint8_t*& ip) {
+inline void Machine::op_set_upvalue(const uint8_t*& ip, Value* regs, const Value* constants) {
     uint16_t uv_idx = READ_U16();
     uint16_t src = READ_U16();
     upvalue_t uv = context_->current_frame_->function_->get_upvalue(uv_idx);
@@ -43,7 +36,7 @@ inline void Machine::op_set_upvalue(const uint8_t*& ip) {
     }
 }
 
-inline void Machine::op_closure(const uint8_t*& ip) {
+inline void Machine::op_closure(const uint8_t*& ip, Value* regs, const Value* constants) {
     uint16_t dst = READ_U16();
     uint16_t proto_idx = READ_U16();
     proto_t proto = CONSTANT(proto_idx).as_proto();
@@ -59,7 +52,7 @@ inline void Machine::op_closure(const uint8_t*& ip) {
     REGISTER(dst) = Value(closure);
 }
 
-inline void Machine::op_close_upvalues(const uint8_t*& ip) {
+inline void Machine::op_close_upvalues(const uint8_t*& ip, Value* regs, const Value* constants) {
     uint16_t last_reg = READ_U16();
     close_upvalues(context_.get(), context_->current_base_ + last_reg);
 }
\ No newline at end of file
@@ -1,26 +1,40 @@
 #pragma once
 // Chứa các handler cho Module, Import, Export
 
-inline void Machine::op_export(const uint8_t*& ip) {
+inline void Machine::op_export(const uint8_t*& ip, Value* regs, const Value* constants) {
     uint16_t name_idx = READ_U16();
     uint16_t src_reg = READ_U16();
     string_t name = CONSTANT(name_idx).as_string();
     context_->current_frame_->module_->set_export(name, REGISTER(src_reg));
 }
 
-inline void Machine::op_get_export(const uint8_t*& ip) {
+inline void Machine::op_get_export(const uint8_t*& ip, Value* regs, const Value* constants) {
     uint16_t dst = READ_U16();
     uint16_t mod_reg = READ_U16();
     uint16_t name_idx = READ_U16();
+    ExportCache* cache = READ_EXPORT_CACHE();
     Value& mod_val = REGISTER(mod_reg);
-    string_t name = CONSTANT(name_idx).as_string();
     if (!mod_val.is_module()) throw_vm_error("GET_EXPORT: operand is not a module.");
     module_t mod = mod_val.as_module();
-    if (!mod->has_export(name)) throw_vm_error("Module does not export name.");
-    REGISTER(dst) = mod->get_export(name);
+
+    // Fast path: site đã resolve cho đúng module này, đọc thẳng slot của module sở hữu
+    if (cache->module_ == mod && cache->epoch_ == mod->get_export_epoch()) {
+        REGISTER(dst) = cache->owner_->get_export_slot(cache->slot_);
+        return;
+    }
+
+    string_t name = CONSTANT(name_idx).as_string();
+    const auto* binding = mod->find_export(name);
+    if (!binding) throw_vm_error("Module does not export name.");
+    REGISTER(dst) = binding->owner_->get_export_slot(binding->slot_);
+
+    // Module còn đang chạy (import vòng) thì bảng export chưa xong, chưa cache
+    if (mod->is_executed()) {
+        *cache = ExportCache{mod, binding->owner_, binding->slot_, mod->get_export_epoch()};
+    }
 }
 
-inline void Machine::op_import_all(const uint8_t*& ip) {
+inline void Machine::op_import_all(const uint8_t*& ip, Value* regs, const Value* constants) {
     uint16_t src_idx = READ_U16();
     const Value& mod_val = REGISTER(src_idx);
     if (auto src_mod = mod_val.as_if_module()) {
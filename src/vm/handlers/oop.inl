@@ -1,14 +1,14 @@
 #pragma once
 // Chứa các handler cho Class, Instance, Prop, Method, Inherit, Super
 
-inline void Machine::op_new_class(const uint8_t*& ip) {
+inline void Machine::op_new_class(const uint8_t*& ip, Value* regs, const Value* constants) {
     uint16_t dst = READ_U16();
     uint16_t name_idx = READ_U16();
     string_t name = CONSTANT(name_idx).as_string();
     REGISTER(dst) = Value(heap_->new_class(name));
 }
 
-inline void Machine::op_new_instance(const uint8_t*& ip) {
+inline void Machine::op_new_instance(const uint8_t*& ip, Value* regs, const Value* constants) {
     uint16_t dst = READ_U16();
     uint16_t class_reg = READ_U16();
     Value& class_val = REGISTER(class_reg);
@@ -16,52 +16,130 @@ inline void Machine::op_new_instance(const uint8_t*& ip) {
     REGISTER(dst) = Value(heap_->new_instance(class_val.as_class()));
 }
 
-inline void Machine::op_get_prop(const uint8_t*& ip) {
-    uint16_t dst = READ_U16();
-    uint16_t obj_reg = READ_U16();
-    uint16_t name_idx = READ_U16();
-    Value& obj = REGISTER(obj_reg);
-    string_t name = CONSTANT(name_idx).as_string();
+// Đường chậm chung của GET_PROP / INVOKE cho instance có shape: tra stub cache toàn VM trước, trượt
+// mới tra bảng băm. Kết quả được ghi vào stub cache và inline cache của site (nếu chưa megamorphic).
+// false nếu instance ở dictionary mode hoặc không có field / method tên đó.
+inline bool Machine::resolve_property(instance_t inst, string_t name, PropertyCache* cache, PropertyCacheEntry& out) {
+    const Shape* shape = inst->get_shape();
+    if (!shape) return false;
+    class_t klass = inst->get_class();
+    StubCache& stubs = context_->stub_cache_;
+
+    if (const PropertyCacheEntry* stub = stubs.lookup(shape->get_id(), name, klass)) {
+        out = *stub;
+    } else if (uint32_t slot = shape->find(name); slot != Shape::NOT_FOUND) {
+        out = {.shape_id_ = shape->get_id(), .slot_ = slot};
+        stubs.insert(name, out);
+    } else if (const Value* method = klass->find_method(name)) {
+        out = {.shape_id_ = shape->get_id(), .method_ = *method, .version_ = klass->get_method_version()};
+        stubs.insert(name, out);
+    } else {
+        return false;
+    }
+    if (!cache->megamorphic_) {
+        cache->update(out);
+    }
+    return true;
+}
+
+inline void Machine::get_prop_slow(Value& dst, Value& obj, string_t name, PropertyCache* cache) {
     if (obj.is_instance()) {
         instance_t inst = obj.as_instance();
-        if (inst->has_field(name)) {
-            REGISTER(dst) = inst->get_field(name);
+        if (PropertyCacheEntry found; resolve_property(inst, name, cache, found)) {
+            if (found.slot_ != Shape::NOT_FOUND) {
+                dst = inst->get_slot(found.slot_);
+            } else {
+                dst = Value(heap_->new_bound_method(inst, found.method_.as_function()));
+            }
+            return;
+        }
+        // Dictionary mode: không có shape để cache nên tra thẳng bảng băm
+        if (Value* field = inst->find_field(name)) {
+            dst = *field;
             return;
         }
-        class_t k = inst->get_class();
-        while (k) {
-            if (k->has_method(name)) {
-                REGISTER(dst) = Value(heap_->new_bound_method(inst, k->get_method(name).as_function()));
+        if (class_t k = inst->get_class()) {
+            if (const Value* method = k->find_method(name)) {
+                dst = Value(heap_->new_bound_method(inst, method->as_function()));
                 return;
             }
-            k = k->get_super();
         }
     }
     if (obj.is_module()) {
         module_t mod = obj.as_module();
-        if (mod->has_export(name)) {
-            REGISTER(dst) = mod->get_export(name);
+        if (const auto* binding = mod->find_export(name)) {
+            dst = binding->owner_->get_export_slot(binding->slot_);
             return;
         }
     }
-    REGISTER(dst) = Value(null_t{});
+    dst = Value(null_t{});
 }
 
-inline void Machine::op_set_prop(const uint8_t*& ip) {
+inline void Machine::op_get_prop(const uint8_t*& ip, Value* regs, const Value* constants) {
+    uint16_t dst = READ_U16();
+    uint16_t obj_reg = READ_U16();
+    uint16_t name_idx = READ_U16();
+    PropertyCache* cache = READ_INLINE_CACHE();
+    Value& obj = REGISTER(obj_reg);
+    if (obj.is_instance()) [[likely]] {
+        instance_t inst = obj.as_instance();
+        if (const Shape* shape = inst->get_shape()) {
+            if (const PropertyCacheEntry* entry = cache->lookup(shape->get_id())) {
+                if (entry->slot_ != Shape::NOT_FOUND) {
+                    REGISTER(dst) = inst->get_slot(entry->slot_);
+                    return;
+                }
+                if (entry->version_ == inst->get_class()->get_method_version()) {
+                    REGISTER(dst) = Value(heap_->new_bound_method(inst, entry->method_.as_function()));
+                    return;
+                }
+            }
+        }
+    }
+    get_prop_slow(REGISTER(dst), obj, CONSTANT(name_idx).as_string(), cache);
+}
+
+inline void Machine::set_prop_slow(Value& obj, string_t name, Value& val, PropertyCache* cache) {
+    if (!obj.is_instance()) {
+        throw_vm_error("SET_PROP: can only set properties on instances.");
+    }
+    instance_t inst = obj.as_instance();
+    Shape* before = inst->get_shape();
+    inst->set_field(name, val);
+    Shape* after = inst->get_shape();
+    if (!before || !after || cache->megamorphic_) return;
+    if (before == after) {
+        cache->update({.shape_id_ = before->get_id(), .slot_ = before->find(name)});
+    } else {
+        // Thêm field mới: lần sau cùng shape cũ thì chuyển thẳng sang shape mới
+        cache->update({.shape_id_ = before->get_id(), .next_shape_ = after});
+    }
+}
+
+inline void Machine::op_set_prop(const uint8_t*& ip, Value* regs, const Value* constants) {
     uint16_t obj_reg = READ_U16();
     uint16_t name_idx = READ_U16();
     uint16_t val_reg = READ_U16();
+    PropertyCache* cache = READ_INLINE_CACHE();
     Value& obj = REGISTER(obj_reg);
-    string_t name = CONSTANT(name_idx).as_string();
     Value& val = REGISTER(val_reg);
-    if (obj.is_instance()) {
-        obj.as_instance()->set_field(name, val);
-    } else {
-        throw_vm_error("SET_PROP: can only set properties on instances.");
+    if (obj.is_instance()) [[likely]] {
+        instance_t inst = obj.as_instance();
+        if (const Shape* shape = inst->get_shape()) {
+            if (const PropertyCacheEntry* entry = cache->lookup(shape->get_id())) {
+                if (entry->next_shape_) {
+                    inst->append_slot(entry->next_shape_, val);
+                } else {
+                    inst->set_slot(entry->slot_, val);
+                }
+                return;
+            }
+        }
     }
+    set_prop_slow(obj, CONSTANT(name_idx).as_string(), val, cache);
 }
 
-inline void Machine::op_set_method(const uint8_t*& ip) {
+inline void Machine::op_set_method(const uint8_t*& ip, Value* regs, const Value* constants) {
     uint16_t call_reg = READ_U16();
     uint16_t name_idx = READ_U16();
     uint16_t method_reg = READ_U16();
@@ -73,7 +151,7 @@ inline void Machine::op_set_method(const uint8_t*& ip) {
     class_val.as_class()->set_method(name, methodVal);
 }
 
-inline void Machine::op_inherit(const uint8_t*& ip) {
+inline void Machine::op_inherit(const uint8_t*& ip, Value* regs, const Value* constants) {
     uint16_t sub_reg = READ_U16();
     uint16_t super_reg = READ_U16();
     Value& sub_val = REGISTER(sub_reg);
@@ -83,10 +161,13 @@ inline void Machine::op_inherit(const uint8_t*& ip) {
     }
     class_t sub = sub_val.as_class();
     class_t super = super_val.as_class();
+    if (super->inherits_from(sub)) {
+        throw_vm_error("INHERIT: Kế thừa vòng tròn (class không thể kế thừa chính nó).");
+    }
     sub->set_super(super);
 }
 
-inline void Machine::op_get_super(const uint8_t*& ip) {
+inline void Machine::op_get_super(const uint8_t*& ip, Value* regs, const Value* constants) {
     uint16_t dst = READ_U16(), name_idx = READ_U16();
     string_t name = CONSTANT(name_idx).as_string();
     Value& receiver_val = REGISTER(0);
@@ -99,17 +180,12 @@ inline void Machine::op_get_super(const uint8_t*& ip) {
     if (super == nullptr) {
         throw_vm_error("GET_SUPER: Class không có superclass.");
     }
-    class_t k = super;
-    while (k) {
-        if (k->has_method(name)) {
-            Value method_val = k->get_method(name);
-            if (!method_val.is_function()) {
-                throw_vm_error("GET_SUPER: Thành viên của superclass không phải là function.");
-            }
-            REGISTER(dst) = Value(heap_->new_bound_method(receiver, method_val.as_function()));
-            return;
+    if (const Value* method_val = super->find_method(name)) {
+        if (!method_val->is_function()) {
+            throw_vm_error("GET_SUPER: Thành viên của superclass không phải là function.");
         }
-        k = k->get_super();
+        REGISTER(dst) = Value(heap_->new_bound_method(receiver, method_val->as_function()));
+        return;
     }
     throw_vm_error("GET_SUPER: Superclass không có method tên là '" + std::string(name->c_str()) + "'.");
 }
\ No newline at end of file
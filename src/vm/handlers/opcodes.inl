@@ -0,0 +1,490 @@
+// Thân của mọi opcode, dùng chung cho cả hai engine dispatch:
+//  - computed goto: file được include thẳng vào vòng lặp trong Machine::run (machine.cpp),
+//    HANDLER(X) là label op_X;
+//  - tail-call: file được include vào TailCallEngine (tailcall.cpp), HANDLER(X) là một hàm riêng.
+// Trong cả hai trường hợp `vm`, `ip`, `regs`, `constants` là các biến có sẵn ở phạm vi ngoài.
+// File này không có #pragma once vì chỉ được include ở đúng một chỗ cho mỗi engine.
+
+HANDLER(LOAD_CONST) {
+    vm->op_load_const(ip, regs, constants);
+    DISPATCH();
+}
+HANDLER(LOAD_NULL) {
+    vm->op_load_null(ip, regs, constants);
+    DISPATCH();
+}
+HANDLER(LOAD_TRUE) {
+    vm->op_load_true(ip, regs, constants);
+    DISPATCH();
+}
+HANDLER(LOAD_FALSE) {
+    vm->op_load_false(ip, regs, constants);
+    DISPATCH();
+}
+HANDLER(MOVE) {
+    vm->op_move(ip, regs, constants);
+    DISPATCH();
+}
+HANDLER(LOAD_INT) {
+    vm->op_load_int(ip, regs, constants);
+    DISPATCH();
+}
+HANDLER(LOAD_FLOAT) {
+    vm->op_load_float(ip, regs, constants);
+    DISPATCH();
+}
+
+HANDLER(ADD) {
+    uint8_t* inst = CURRENT_INSTRUCTION();
+    uint16_t dst = READ_U16();
+    uint16_t r1  = READ_U16();
+    uint16_t r2  = READ_U16();
+    
+    auto& left  = REGISTER(r1);
+    auto& right = REGISTER(r2);
+    if (left.is_small_int() && right.is_small_int()) [[likely]] {
+        QUICKEN(inst, ADD_II);
+        SMALL_INT_ARITH(dst, add, "ADD", left.as_small_int(), right.as_small_int());
+    } else if (left.is_float() && right.is_float()) {
+        QUICKEN(inst, ADD_FF);
+        REGISTER(dst) = value_t(left.as_float() + right.as_float());
+    } else if (IS_NUMBER(left) && IS_NUMBER(right) && !(left.is_int() && right.is_int())) {
+        REGISTER(dst) = value_t(NUMBER_AS_FLOAT(left) + NUMBER_AS_FLOAT(right));
+    } else {
+        if (left.is_string() && right.is_string()) {
+            QUICKEN(inst, ADD_SS);
+        }
+        BINARY_OP_FALLBACK(ADD, "ADD", dst, left, right);
+    }
+    DISPATCH();
+}
+
+// BINARY_OP_HANDLER(ADD,     "ADD")
+QUICKENING_ARITH_OP_HANDLER(SUB, "SUB", -, sub)
+QUICKENING_ARITH_OP_HANDLER(MUL, "MUL", *, mul)
+
+HANDLER(DIV) {
+    uint8_t* inst = CURRENT_INSTRUCTION();
+    uint16_t dst = READ_U16();
+    uint16_t r1  = READ_U16();
+    uint16_t r2  = READ_U16();
+
+    auto& left  = REGISTER(r1);
+    auto& right = REGISTER(r2);
+    if (left.is_float() && right.is_float()) {
+        QUICKEN(inst, DIV_FF);
+        REGISTER(dst) = value_t(left.as_float() / right.as_float());
+    } else if (IS_NUMBER(left) && IS_NUMBER(right) && !(left.is_int() && right.is_int())) {
+        REGISTER(dst) = value_t(NUMBER_AS_FLOAT(left) / NUMBER_AS_FLOAT(right));
+    } else {
+        BINARY_OP_FALLBACK(DIV, "DIV", dst, left, right);
+    }
+    DISPATCH();
+}
+HANDLER(MOD) {
+    uint8_t* inst = CURRENT_INSTRUCTION();
+    uint16_t dst = READ_U16();
+    uint16_t r1  = READ_U16();
+    uint16_t r2  = READ_U16();
+
+    auto& left  = REGISTER(r1);
+    auto& right = REGISTER(r2);
+    if (left.is_small_int() && right.is_small_int()) {
+        QUICKEN(inst, MOD_II);
+        if (right.as_small_int() == 0) [[unlikely]] {
+            SAVE_IP();
+            vm->throw_vm_error("Division by zero in MOD");
+        }
+        REGISTER(dst) = Value::small_int(left.as_small_int() % right.as_small_int());
+    } else {
+        BINARY_OP_FALLBACK(MOD, "MOD", dst, left, right);
+    }
+    DISPATCH();
+}
+
+BINARY_OP_HANDLER(POW,     "POW")
+QUICKENING_COMPARE_OP_HANDLER(EQ,  "EQ",  ==)
+QUICKENING_COMPARE_OP_HANDLER(NEQ, "NEQ", !=)
+QUICKENING_COMPARE_OP_HANDLER(GT,  "GT",  >)
+QUICKENING_COMPARE_OP_HANDLER(GE,  "GE",  >=)
+QUICKENING_COMPARE_OP_HANDLER(LT,  "LT",  <)
+QUICKENING_COMPARE_OP_HANDLER(LE,  "LE",  <=)
+INT_BINARY_OP_HANDLER(BIT_AND, "BIT_AND", &)
+INT_BINARY_OP_HANDLER(BIT_OR,  "BIT_OR",  |)
+INT_BINARY_OP_HANDLER(BIT_XOR, "BIT_XOR", ^)
+BINARY_OP_HANDLER(LSHIFT,  "LSHIFT")
+BINARY_OP_HANDLER(RSHIFT,  "RSHIFT")
+
+UNARY_OP_HANDLER(NEG,     "NEG")
+UNARY_OP_HANDLER(NOT,     "NOT")
+UNARY_OP_HANDLER(BIT_NOT, "BIT_NOT")
+
+// --- Quickened forms ---
+SPECIALIZED_INT_ARITH_HANDLER(ADD_II, ADD, "ADD", add)
+SPECIALIZED_FLOAT_OP_HANDLER(ADD_FF, ADD, +)
+HANDLER(ADD_SS) {
+    uint8_t* inst = CURRENT_INSTRUCTION();
+    uint16_t dst = READ_U16();
+    uint16_t r1  = READ_U16();
+    uint16_t r2  = READ_U16();
+
+    auto& left  = REGISTER(r1);
+    auto& right = REGISTER(r2);
+    if (left.is_string() && right.is_string()) [[likely]] {
+        {
+            SAVE_IP();
+            string_t lhs = left.as_string();
+            string_t rhs = right.as_string();
+            std::string joined;
+            joined.reserve(lhs->size() + rhs->size());
+            joined.append(lhs->c_str(), lhs->size()).append(rhs->c_str(), rhs->size());
+            REGISTER(dst) = Value(vm->heap_->new_string(joined));
+        }
+        DISPATCH();
+    }
+    DEOPTIMIZE(inst, ADD);
+}
+SPECIALIZED_INT_ARITH_HANDLER(SUB_II, SUB, "SUB", sub)
+SPECIALIZED_FLOAT_OP_HANDLER(SUB_FF, SUB, -)
+SPECIALIZED_INT_ARITH_HANDLER(MUL_II, MUL, "MUL", mul)
+SPECIALIZED_FLOAT_OP_HANDLER(MUL_FF, MUL, *)
+SPECIALIZED_FLOAT_OP_HANDLER(DIV_FF, DIV, /)
+HANDLER(MOD_II) {
+    uint8_t* inst = CURRENT_INSTRUCTION();
+    uint16_t dst = READ_U16();
+    uint16_t r1  = READ_U16();
+    uint16_t r2  = READ_U16();
+
+    auto& left  = REGISTER(r1);
+    auto& right = REGISTER(r2);
+    if (left.is_small_int() && right.is_small_int()) [[likely]] {
+        if (right.as_small_int() == 0) [[unlikely]] {
+            SAVE_IP();
+            vm->throw_vm_error("Division by zero in MOD");
+        }
+        REGISTER(dst) = Value::small_int(left.as_small_int() % right.as_small_int());
+        DISPATCH();
+    }
+    DEOPTIMIZE(inst, MOD);
+}
+SPECIALIZED_INT_OP_HANDLER(EQ_II, EQ, ==)
+SPECIALIZED_FLOAT_OP_HANDLER(EQ_FF, EQ, ==)
+SPECIALIZED_INT_OP_HANDLER(NEQ_II, NEQ, !=)
+SPECIALIZED_FLOAT_OP_HANDLER(NEQ_FF, NEQ, !=)
+SPECIALIZED_INT_OP_HANDLER(GT_II, GT, >)
+SPECIALIZED_FLOAT_OP_HANDLER(GT_FF, GT, >)
+SPECIALIZED_INT_OP_HANDLER(GE_II, GE, >=)
+SPECIALIZED_FLOAT_OP_HANDLER(GE_FF, GE, >=)
+SPECIALIZED_INT_OP_HANDLER(LT_II, LT, <)
+SPECIALIZED_FLOAT_OP_HANDLER(LT_FF, LT, <)
+SPECIALIZED_INT_OP_HANDLER(LE_II, LE, <=)
+SPECIALIZED_FLOAT_OP_HANDLER(LE_FF, LE, <=)
+
+// --- Superinstructions ---
+// Cộng small int / float ngay tại chỗ. Kiểu khác thì quay về record của ADD và dispatch qua ô handler
+// của nó (có thể đã được quicken), không nhảy cứng vào ADD generic
+HANDLER(LOAD_INT_ADD) {
+    vm->op_load_int(ip, regs, constants);
+    const uint8_t* add_record = ip;
+    SKIP_OPCODE();
+    uint16_t dst = READ_U16();
+    uint16_t r1  = READ_U16();
+    uint16_t r2  = READ_U16();
+
+    auto& left  = REGISTER(r1);
+    auto& right = REGISTER(r2);
+    if (left.is_small_int() && right.is_small_int()) [[likely]] {
+        SMALL_INT_ARITH(dst, add, "ADD", left.as_small_int(), right.as_small_int());
+    } else if (left.is_float() && right.is_float()) {
+        REGISTER(dst) = Value(left.as_float() + right.as_float());
+    } else {
+        ip = add_record;
+    }
+    DISPATCH();
+}
+HANDLER(MOVE_MOVE) {
+    vm->op_move(ip, regs, constants);
+    SKIP_OPCODE();
+    vm->op_move(ip, regs, constants);
+    DISPATCH();
+}
+HANDLER(GET_PROP_MOVE) {
+    SAVE_IP();
+    vm->op_get_prop(ip, regs, constants);
+    SKIP_OPCODE();
+    vm->op_move(ip, regs, constants);
+    DISPATCH();
+}
+HANDLER(LT_JUMP_IF_FALSE) {
+    uint16_t dst = READ_U16();
+    uint16_t r1  = READ_U16();
+    uint16_t r2  = READ_U16();
+    SKIP_OPCODE();
+    (void)READ_U16(); // reg của JUMP_IF_FALSE, luôn trùng dst
+    int32_t offset = READ_JUMP();
+
+    auto& left  = REGISTER(r1);
+    auto& right = REGISTER(r2);
+    bool condition;
+    if (left.is_small_int() && right.is_small_int()) [[likely]] {
+        condition = left.as_small_int() < right.as_small_int();
+        REGISTER(dst) = Value(condition);
+    } else if (left.is_float() && right.is_float()) {
+        condition = left.as_float() < right.as_float();
+        REGISTER(dst) = Value(condition);
+    } else {
+        BINARY_OP_FALLBACK(LT, "LT", dst, left, right);
+        condition = to_bool(REGISTER(dst));
+    }
+    if (!condition) {
+        JUMP_BY(offset);
+    }
+    DISPATCH();
+}
+
+HANDLER(GET_GLOBAL) {
+    SAVE_IP();
+    vm->op_get_global(ip, regs, constants);
+    DISPATCH();
+}
+HANDLER(SET_GLOBAL) {
+    SAVE_IP();
+    vm->op_set_global(ip, regs, constants);
+    DISPATCH();
+}
+HANDLER(GET_UPVALUE) {
+    vm->op_get_upvalue(ip, regs, constants);
+    DISPATCH();
+}
+HANDLER(SET_UPVALUE) {
+    vm->op_set_upvalue(ip, regs, constants);
+    DISPATCH();
+}
+HANDLER(CLOSURE) {
+    SAVE_IP();
+    vm->op_closure(ip, regs, constants);
+    DISPATCH();
+}
+HANDLER(CLOSE_UPVALUES) {
+    vm->op_close_upvalues(ip, regs, constants);
+    DISPATCH();
+}
+
+HANDLER(JUMP) {
+    int32_t offset = READ_JUMP();
+    JUMP_BY(offset);
+    DISPATCH();
+}
+HANDLER(JUMP_IF_FALSE) {
+    uint16_t reg = READ_U16();
+    int32_t offset = READ_JUMP();
+    bool is_truthy_val = to_bool(REGISTER(reg));
+    if (!is_truthy_val) {
+        JUMP_BY(offset);
+    }
+    DISPATCH();
+}
+HANDLER(JUMP_IF_TRUE) {
+    uint16_t reg = READ_U16();
+    int32_t offset = READ_JUMP();
+    bool is_truthy_val = to_bool(REGISTER(reg));
+    if (is_truthy_val) {
+        JUMP_BY(offset);
+    }
+    DISPATCH();
+}
+COMPARE_JUMP_HANDLER(JEQ, EQ, "EQ", ==)
+COMPARE_JUMP_HANDLER(JNE, NEQ, "NEQ", !=)
+COMPARE_JUMP_HANDLER(JLT, LT, "LT", <)
+COMPARE_JUMP_HANDLER(JLE, LE, "LE", <=)
+COMPARE_IMM_JUMP_HANDLER(JEQ_I, EQ, "EQ", ==)
+COMPARE_IMM_JUMP_HANDLER(JNE_I, NEQ, "NEQ", !=)
+COMPARE_IMM_JUMP_HANDLER(JLT_I, LT, "LT", <)
+COMPARE_IMM_JUMP_HANDLER(JLE_I, LE, "LE", <=)
+COMPARE_IMM_JUMP_HANDLER(JGT_I, GT, "GT", >)
+COMPARE_IMM_JUMP_HANDLER(JGE_I, GE, "GE", >=)
+HANDLER(CALL) {
+    uint16_t dst = READ_U16();
+    uint16_t fn_reg = READ_U16();
+    uint16_t arg_start = READ_U16();
+    uint16_t argc = READ_U16();
+    size_t ret_reg = (dst == 0xFFFF) ? static_cast<size_t>(-1) : static_cast<size_t>(dst);
+    SAVE_IP();
+    vm->call_value(ret_reg, fn_reg, arg_start, argc);
+    ENTER_FRAME();
+    DISPATCH();
+}
+HANDLER(CALL_VOID) {
+    uint16_t fn_reg = READ_U16();
+    uint16_t arg_start = READ_U16();
+    uint16_t argc = READ_U16();
+    SAVE_IP();
+    vm->call_value(static_cast<size_t>(-1), fn_reg, arg_start, argc);
+    ENTER_FRAME();
+    DISPATCH();
+}
+HANDLER(TAIL_CALL) {
+    uint16_t fn_reg = READ_U16();
+    uint16_t arg_start = READ_U16();
+    uint16_t argc = READ_U16();
+    SAVE_IP();
+    if (!vm->tail_call_value(fn_reg, arg_start, argc)) {
+        return; // Dừng VM, quay về run()
+    }
+    ENTER_FRAME();
+    DISPATCH();
+}
+HANDLER(INVOKE) {
+    uint16_t dst = READ_U16();
+    uint16_t obj_reg = READ_U16();
+    uint16_t name_idx = READ_U16();
+    uint16_t arg_start = READ_U16();
+    uint16_t argc = READ_U16();
+    PropertyCache* cache = READ_INLINE_CACHE();
+    size_t ret_reg = (dst == 0xFFFF) ? static_cast<size_t>(-1) : static_cast<size_t>(dst);
+    SAVE_IP();
+    vm->invoke_method(ret_reg, obj_reg, CONSTANT(name_idx).as_string(), arg_start, argc, cache);
+    ENTER_FRAME();
+    DISPATCH();
+}
+HANDLER(RETURN) {
+    uint16_t ret_reg_idx = READ_U16();
+    if (!vm->return_from_frame((ret_reg_idx == 0xFFFF) ? Value(null_t{}) : REGISTER(ret_reg_idx))) {
+        return; // Dừng VM, quay về run()
+    }
+    LOAD_FRAME();
+    DISPATCH();
+}
+
+HANDLER(NEW_ARRAY) {
+    SAVE_IP();
+    vm->op_new_array(ip, regs, constants);
+    DISPATCH();
+}
+HANDLER(NEW_HASH) {
+    SAVE_IP();
+    vm->op_new_hash(ip, regs, constants);
+    DISPATCH();
+}
+HANDLER(GET_INDEX) {
+    SAVE_IP();
+    vm->op_get_index(ip, regs, constants);
+    DISPATCH();
+}
+HANDLER(SET_INDEX) {
+    SAVE_IP();
+    vm->op_set_index(ip, regs, constants);
+    DISPATCH();
+}
+HANDLER(GET_KEYS) {
+    SAVE_IP();
+    vm->op_get_keys(ip, regs, constants);
+    DISPATCH();
+}
+HANDLER(GET_VALUES) {
+    SAVE_IP();
+    vm->op_get_values(ip, regs, constants);
+    DISPATCH();
+}
+HANDLER(NEW_CLASS) {
+    SAVE_IP();
+    vm->op_new_class(ip, regs, constants);
+    DISPATCH();
+}
+HANDLER(NEW_INSTANCE) {
+    SAVE_IP();
+    vm->op_new_instance(ip, regs, constants);
+    DISPATCH();
+}
+HANDLER(GET_PROP) {
+    SAVE_IP();
+    vm->op_get_prop(ip, regs, constants);
+    DISPATCH();
+}
+HANDLER(SET_PROP) {
+    SAVE_IP();
+    vm->op_set_prop(ip, regs, constants);
+    DISPATCH();
+}
+HANDLER(SET_METHOD) {
+    SAVE_IP();
+    vm->op_set_method(ip, regs, constants);
+    DISPATCH();
+}
+HANDLER(INHERIT) {
+    SAVE_IP();
+    vm->op_inherit(ip, regs, constants);
+    DISPATCH();
+}
+HANDLER(GET_SUPER) {
+    SAVE_IP();
+    vm->op_get_super(ip, regs, constants);
+    DISPATCH();
+}
+
+HANDLER(THROW) {
+    SAVE_IP();
+    vm->op_throw(ip, regs, constants);
+    DISPATCH();
+}
+HANDLER(SETUP_TRY) {
+    vm->op_setup_try(ip, regs, constants);
+    DISPATCH();
+}
+HANDLER(POP_TRY) {
+    vm->op_pop_try();
+    DISPATCH();
+}
+HANDLER(IMPORT_MODULE) {
+    uint16_t dst = READ_U16();
+    uint16_t path_idx = READ_U16();
+    SAVE_IP();
+    string_t path = CONSTANT(path_idx).as_string();
+    string_t importer_path = vm->context_->current_frame_->module_->get_file_path();
+    module_t mod = vm->mod_manager_->load_module(path, importer_path);
+    REGISTER(dst) = Value(mod);
+    if (mod->is_executed() || mod->is_executing()) {
+        DISPATCH();
+    }
+    if (!mod->is_has_main()) {
+        mod->set_executed();
+        DISPATCH();
+    }
+
+    mod->set_execution();
+    proto_t main_proto = mod->get_main_proto();
+    function_t main_closure = vm->heap_->new_function(main_proto);
+    size_t new_base = vm->context_->registers_.size();
+    vm->context_->registers_.resize(new_base + main_proto->get_num_registers());
+    vm->context_->current_frame_ = &vm->context_->call_stack_.emplace_back(main_closure, mod, new_base, static_cast<size_t>(-1));
+    vm->context_->current_base_ = vm->context_->current_frame_->start_reg_;
+    ENTER_FRAME();
+    
+    DISPATCH();
+}
+
+HANDLER(EXPORT) {
+    SAVE_IP();
+    vm->op_export(ip, regs, constants);
+    DISPATCH();
+}
+HANDLER(GET_EXPORT) {
+    SAVE_IP();
+    vm->op_get_export(ip, regs, constants);
+    DISPATCH();
+}
+HANDLER(IMPORT_ALL) {
+    SAVE_IP();
+    vm->op_import_all(ip, regs, constants);
+    DISPATCH();
+}
+
+HANDLER(HALT) {
+    printl("halt");
+    if (!vm->context_->registers_.empty()) {
+        if (REGISTER(0).is_int()) {
+            printl("Final value in R0: {}", REGISTER(0).as_int());
+        }
+    }
+    return;
+}
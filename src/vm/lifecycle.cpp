@@ -24,13 +24,15 @@ Machine::Machine(const std::string& entry_point_directory, const std::string& en
     heap_ = std::make_unique<MemoryManager>(std::move(gc));
 
     mod_manager_ = std::make_unique<ModuleManager>(heap_.get(), this);
-    op_dispatcher_ = std::make_unique<OperatorDispatcher>(heap_.get());
+    op_dispatcher_ = std::make_unique<OperatorDispatcher>();
 
     printl("Machine initialized successfully!");
     printl("Detected size of value is: {} bytes", sizeof(value_t));
 }
 
 Machine::~Machine() noexcept {
+    const StubCacheStats& stubs = context_->stub_cache_.get_stats();
+    printl("Stub cache: {} hit(s), {} miss(es), {} eviction(s)", stubs.hits_, stubs.misses_, stubs.evictions_);
     printl("Machine shutting down.");
 }
 
@@ -64,15 +66,13 @@ void Machine::prepare() noexcept {
 
         context_->registers_.resize(main_proto->get_num_registers());
 
-        context_->call_stack_.emplace_back(
+        context_->current_frame_ = &context_->call_stack_.emplace_back(
             main_func, 
             main_module, 
             0,
-            static_cast<size_t>(-1),
-            main_proto->get_chunk().get_code()
+            static_cast<size_t>(-1)
         );
 
-        context_->current_frame_ = &context_->call_stack_.back();
         context_->current_base_ = context_->current_frame_->start_reg_;
         
         printl("Module loaded successfully. Starting VM loop...");
@@ -0,0 +1,185 @@
+// Engine dispatch thứ hai: mỗi opcode là một hàm riêng, nối nhau bằng tail call bắt buộc
+// ([[clang::musttail]] / [[gnu::musttail]]). ip, regs và constants đi theo tham số nên được giữ
+// trong thanh ghi suốt chuỗi handler, thay vì phụ thuộc register allocator của một hàm khổng lồ.
+// Bật bằng -DMEOW_DISPATCH_ENGINE=tailcall; mặc định VM dùng computed goto trong machine.cpp.
+#if defined(MEOW_USE_TAILCALL_DISPATCH)
+
+#include "vm/machine.h"
+#include "common/pch.h"
+#include "bytecode/op_codes.h"
+#include "memory/memory_manager.h"
+#include "module/module_manager.h"
+#include "runtime/execution_context.h"
+#include "runtime/operator_dispatcher.h"
+#include "runtime/upvalue.h"
+#include "vm/macros.h"
+#include "common/cast.h"
+#include "debug/print.h"
+#include "runtime/error_recovery.h"
+
+#include "core/objects/array.h"
+#include "core/objects/function.h"
+#include "core/objects/hash_table.h"
+#include "core/objects/module.h"
+#include "core/objects/oop.h"
+
+using namespace meow;
+
+#include "handlers/load.inl"
+#include "handlers/memory.inl"
+#include "handlers/data.inl"
+#include "handlers/oop.inl"
+#include "handlers/module.inl"
+#include "handlers/exception.inl"
+#include "handlers/call.inl"
+
+namespace meow {
+
+using TailCallHandler = void (*)(Machine*, const uint8_t*, Value*, const Value*);
+
+struct TailCallEngine {
+#include "handlers/opcodes.inl"
+
+    // Vào chuỗi handler tại ip hiện tại; trả về khi VM dừng (RETURN ở frame cuối / HALT)
+    static void enter(Machine* vm, const uint8_t* ip, Value* regs, const Value* constants) {
+        ALIGN_IP(sizeof(InstructionRecord));
+        const void* handler = load_operand<const void*>(ip);
+        ip += sizeof(const void*);
+        reinterpret_cast<TailCallHandler>(const_cast<void*>(handler))(vm, ip, regs, constants);
+    }
+
+    static const void* const handlers[static_cast<size_t>(OpCode::TOTAL_OPCODES)];
+};
+
+#define MEOW_TAILCALL_ENTRY(OPCODE) reinterpret_cast<const void*>(&TailCallEngine::op_##OPCODE)
+
+const void* const TailCallEngine::handlers[static_cast<size_t>(OpCode::TOTAL_OPCODES)] = {
+    [+OpCode::LOAD_CONST]       = MEOW_TAILCALL_ENTRY(LOAD_CONST),
+    [+OpCode::LOAD_NULL]        = MEOW_TAILCALL_ENTRY(LOAD_NULL),
+    [+OpCode::LOAD_TRUE]        = MEOW_TAILCALL_ENTRY(LOAD_TRUE),
+    [+OpCode::LOAD_FALSE]       = MEOW_TAILCALL_ENTRY(LOAD_FALSE),
+    [+OpCode::LOAD_INT]         = MEOW_TAILCALL_ENTRY(LOAD_INT),
+    [+OpCode::LOAD_FLOAT]       = MEOW_TAILCALL_ENTRY(LOAD_FLOAT),
+    [+OpCode::MOVE]             = MEOW_TAILCALL_ENTRY(MOVE),
+    [+OpCode::ADD]              = MEOW_TAILCALL_ENTRY(ADD),
+    [+OpCode::SUB]              = MEOW_TAILCALL_ENTRY(SUB),
+    [+OpCode::MUL]              = MEOW_TAILCALL_ENTRY(MUL),
+    [+OpCode::DIV]              = MEOW_TAILCALL_ENTRY(DIV),
+    [+OpCode::MOD]              = MEOW_TAILCALL_ENTRY(MOD),
+    [+OpCode::POW]              = MEOW_TAILCALL_ENTRY(POW),
+    [+OpCode::EQ]               = MEOW_TAILCALL_ENTRY(EQ),
+    [+OpCode::NEQ]              = MEOW_TAILCALL_ENTRY(NEQ),
+    [+OpCode::GT]               = MEOW_TAILCALL_ENTRY(GT),
+    [+OpCode::GE]               = MEOW_TAILCALL_ENTRY(GE),
+    [+OpCode::LT]               = MEOW_TAILCALL_ENTRY(LT),
+    [+OpCode::LE]               = MEOW_TAILCALL_ENTRY(LE),
+    [+OpCode::NEG]              = MEOW_TAILCALL_ENTRY(NEG),
+    [+OpCode::NOT]              = MEOW_TAILCALL_ENTRY(NOT),
+    [+OpCode::GET_GLOBAL]       = MEOW_TAILCALL_ENTRY(GET_GLOBAL),
+    [+OpCode::SET_GLOBAL]       = MEOW_TAILCALL_ENTRY(SET_GLOBAL),
+    [+OpCode::GET_UPVALUE]      = MEOW_TAILCALL_ENTRY(GET_UPVALUE),
+    [+OpCode::SET_UPVALUE]      = MEOW_TAILCALL_ENTRY(SET_UPVALUE),
+    [+OpCode::CLOSURE]          = MEOW_TAILCALL_ENTRY(CLOSURE),
+    [+OpCode::CLOSE_UPVALUES]   = MEOW_TAILCALL_ENTRY(CLOSE_UPVALUES),
+    [+OpCode::JUMP]             = MEOW_TAILCALL_ENTRY(JUMP),
+    [+OpCode::JUMP_IF_FALSE]    = MEOW_TAILCALL_ENTRY(JUMP_IF_FALSE),
+    [+OpCode::JUMP_IF_TRUE]     = MEOW_TAILCALL_ENTRY(JUMP_IF_TRUE),
+    [+OpCode::CALL]             = MEOW_TAILCALL_ENTRY(CALL),
+    [+OpCode::CALL_VOID]        = MEOW_TAILCALL_ENTRY(CALL_VOID),
+    [+OpCode::RETURN]           = MEOW_TAILCALL_ENTRY(RETURN),
+    [+OpCode::HALT]             = MEOW_TAILCALL_ENTRY(HALT),
+    [+OpCode::NEW_ARRAY]        = MEOW_TAILCALL_ENTRY(NEW_ARRAY),
+    [+OpCode::NEW_HASH]         = MEOW_TAILCALL_ENTRY(NEW_HASH),
+    [+OpCode::GET_INDEX]        = MEOW_TAILCALL_ENTRY(GET_INDEX),
+    [+OpCode::SET_INDEX]        = MEOW_TAILCALL_ENTRY(SET_INDEX),
+    [+OpCode::GET_KEYS]         = MEOW_TAILCALL_ENTRY(GET_KEYS),
+    [+OpCode::GET_VALUES]       = MEOW_TAILCALL_ENTRY(GET_VALUES),
+    [+OpCode::NEW_CLASS]        = MEOW_TAILCALL_ENTRY(NEW_CLASS),
+    [+OpCode::NEW_INSTANCE]     = MEOW_TAILCALL_ENTRY(NEW_INSTANCE),
+    [+OpCode::GET_PROP]         = MEOW_TAILCALL_ENTRY(GET_PROP),
+    [+OpCode::SET_PROP]         = MEOW_TAILCALL_ENTRY(SET_PROP),
+    [+OpCode::SET_METHOD]       = MEOW_TAILCALL_ENTRY(SET_METHOD),
+    [+OpCode::INHERIT]          = MEOW_TAILCALL_ENTRY(INHERIT),
+    [+OpCode::GET_SUPER]        = MEOW_TAILCALL_ENTRY(GET_SUPER),
+    [+OpCode::BIT_AND]          = MEOW_TAILCALL_ENTRY(BIT_AND),
+    [+OpCode::BIT_OR]           = MEOW_TAILCALL_ENTRY(BIT_OR),
+    [+OpCode::BIT_XOR]          = MEOW_TAILCALL_ENTRY(BIT_XOR),
+    [+OpCode::BIT_NOT]          = MEOW_TAILCALL_ENTRY(BIT_NOT),
+    [+OpCode::LSHIFT]           = MEOW_TAILCALL_ENTRY(LSHIFT),
+    [+OpCode::RSHIFT]           = MEOW_TAILCALL_ENTRY(RSHIFT),
+    [+OpCode::THROW]            = MEOW_TAILCALL_ENTRY(THROW),
+    [+OpCode::SETUP_TRY]        = MEOW_TAILCALL_ENTRY(SETUP_TRY),
+    [+OpCode::POP_TRY]          = MEOW_TAILCALL_ENTRY(POP_TRY),
+    [+OpCode::IMPORT_MODULE]    = MEOW_TAILCALL_ENTRY(IMPORT_MODULE),
+    [+OpCode::EXPORT]           = MEOW_TAILCALL_ENTRY(EXPORT),
+    [+OpCode::GET_EXPORT]       = MEOW_TAILCALL_ENTRY(GET_EXPORT),
+    [+OpCode::IMPORT_ALL]       = MEOW_TAILCALL_ENTRY(IMPORT_ALL),
+    [+OpCode::ADD_II]           = MEOW_TAILCALL_ENTRY(ADD_II),
+    [+OpCode::ADD_FF]           = MEOW_TAILCALL_ENTRY(ADD_FF),
+    [+OpCode::ADD_SS]           = MEOW_TAILCALL_ENTRY(ADD_SS),
+    [+OpCode::SUB_II]           = MEOW_TAILCALL_ENTRY(SUB_II),
+    [+OpCode::SUB_FF]           = MEOW_TAILCALL_ENTRY(SUB_FF),
+    [+OpCode::MUL_II]           = MEOW_TAILCALL_ENTRY(MUL_II),
+    [+OpCode::MUL_FF]           = MEOW_TAILCALL_ENTRY(MUL_FF),
+    [+OpCode::DIV_FF]           = MEOW_TAILCALL_ENTRY(DIV_FF),
+    [+OpCode::MOD_II]           = MEOW_TAILCALL_ENTRY(MOD_II),
+    [+OpCode::EQ_II]            = MEOW_TAILCALL_ENTRY(EQ_II),
+    [+OpCode::EQ_FF]            = MEOW_TAILCALL_ENTRY(EQ_FF),
+    [+OpCode::NEQ_II]           = MEOW_TAILCALL_ENTRY(NEQ_II),
+    [+OpCode::NEQ_FF]           = MEOW_TAILCALL_ENTRY(NEQ_FF),
+    [+OpCode::GT_II]            = MEOW_TAILCALL_ENTRY(GT_II),
+    [+OpCode::GT_FF]            = MEOW_TAILCALL_ENTRY(GT_FF),
+    [+OpCode::GE_II]            = MEOW_TAILCALL_ENTRY(GE_II),
+    [+OpCode::GE_FF]            = MEOW_TAILCALL_ENTRY(GE_FF),
+    [+OpCode::LT_II]            = MEOW_TAILCALL_ENTRY(LT_II),
+    [+OpCode::LT_FF]            = MEOW_TAILCALL_ENTRY(LT_FF),
+    [+OpCode::LE_II]            = MEOW_TAILCALL_ENTRY(LE_II),
+    [+OpCode::LE_FF]            = MEOW_TAILCALL_ENTRY(LE_FF),
+    [+OpCode::LOAD_INT_ADD]     = MEOW_TAILCALL_ENTRY(LOAD_INT_ADD),
+    [+OpCode::MOVE_MOVE]        = MEOW_TAILCALL_ENTRY(MOVE_MOVE),
+    [+OpCode::GET_PROP_MOVE]    = MEOW_TAILCALL_ENTRY(GET_PROP_MOVE),
+    [+OpCode::LT_JUMP_IF_FALSE] = MEOW_TAILCALL_ENTRY(LT_JUMP_IF_FALSE),
+    [+OpCode::JEQ]              = MEOW_TAILCALL_ENTRY(JEQ),
+    [+OpCode::JNE]              = MEOW_TAILCALL_ENTRY(JNE),
+    [+OpCode::JLT]              = MEOW_TAILCALL_ENTRY(JLT),
+    [+OpCode::JLE]              = MEOW_TAILCALL_ENTRY(JLE),
+    [+OpCode::JEQ_I]            = MEOW_TAILCALL_ENTRY(JEQ_I),
+    [+OpCode::JNE_I]            = MEOW_TAILCALL_ENTRY(JNE_I),
+    [+OpCode::JLT_I]            = MEOW_TAILCALL_ENTRY(JLT_I),
+    [+OpCode::JLE_I]            = MEOW_TAILCALL_ENTRY(JLE_I),
+    [+OpCode::JGT_I]            = MEOW_TAILCALL_ENTRY(JGT_I),
+    [+OpCode::JGE_I]            = MEOW_TAILCALL_ENTRY(JGE_I),
+    [+OpCode::TAIL_CALL]        = MEOW_TAILCALL_ENTRY(TAIL_CALL),
+    [+OpCode::INVOKE]           = MEOW_TAILCALL_ENTRY(INVOKE),
+};
+
+#undef MEOW_TAILCALL_ENTRY
+
+void Machine::run() {
+    printl("Starting Machine execution loop (Tail Call)...");
+
+    Machine* const vm = this;
+    const uint8_t* ip = nullptr;
+    Value* regs = nullptr;
+    const Value* constants = nullptr;
+
+    dispatch_table_ = TailCallEngine::handlers;
+    ENTER_FRAME();
+
+    while (true) {
+        try {
+            TailCallEngine::enter(vm, ip, regs, constants);
+            return;
+        } catch (const VMError& e) {
+            if (!recover_from_error(e, context_.get(), heap_.get())) {
+                return;
+            }
+            // Cứu được: nạp lại ip/regs/constants từ frame rồi vào lại chuỗi handler
+            LOAD_FRAME();
+        }
+    }
+}
+
+}
+
+#endif
@@ -6,50 +6,9 @@
 #include <bit>
 #include <cstdint>
 
-enum class OpCode : uint8_t {
-    // --- Load/store ---
-    LOAD_CONST, LOAD_NULL, LOAD_TRUE, LOAD_FALSE,
-    LOAD_INT, LOAD_FLOAT,
-    MOVE,
-    // --- Binary ---
-    ADD, SUB, MUL, DIV, MOD, POW,
-    EQ, NEQ, GT, GE, LT, LE,
-    // --- Unary ---
-    NEG, NOT,
-    // --- Constant & variable
-    GET_GLOBAL, SET_GLOBAL,
-    GET_UPVALUE, SET_UPVALUE,
-    CLOSURE,
-    CLOSE_UPVALUES,
-    // --- Control flow ---
-    JUMP,
-    JUMP_IF_FALSE, JUMP_IF_TRUE,
-    CALL, CALL_VOID,
-    RETURN,
-    HALT,
-    // --- Data structure ---
-    NEW_ARRAY, NEW_HASH,
-    GET_INDEX, SET_INDEX,
-    GET_KEYS, GET_VALUES,
-    // --- Classes & objexts ---
-    NEW_CLASS, NEW_INSTANCE,
-    GET_PROP, SET_PROP, SET_METHOD,
-    INHERIT,
-    GET_SUPER,
-    // --- Bitwise ---
-    BIT_AND, BIT_OR, BIT_XOR, BIT_NOT, LSHIFT, RSHIFT,
-    // --- Try/catch ---
-    THROW,
-    SETUP_TRY,
-    POP_TRY,
-    // --- Module ---
-    IMPORT_MODULE,
-    EXPORT,
-    GET_EXPORT,
-    IMPORT_ALL,
-    // --- Metadata ---
-    TOTAL_OPCODES
-};
+#include "bytecode/op_codes.h"
+
+using meow::OpCode;
 
 // Cấu trúc file binary dựa trên src/bytecode/binary_loader.cpp:
 // 1. Magic (u32): 0x4D454F57 ("MEOW")
@@ -67,8 +26,85 @@ void write_str(std::ofstream& out, const std::string& s) {
     out.write(s.data(), s.size());
 }
 
-int main() {
-    std::ofstream out("test.meowb", std::ios::binary);
+void emit_u16(std::vector<uint8_t>& code, uint16_t v) {
+    code.push_back(v & 0xFF);
+    code.push_back((v >> 8) & 0xFF);
+}
+void emit_i64(std::vector<uint8_t>& code, int64_t v) {
+    uint64_t bits = std::bit_cast<uint64_t>(v);
+    for (int i = 0; i < 8; ++i) code.push_back((bits >> (i * 8)) & 0xFF);
+}
+void write_code(std::ofstream& out, const std::vector<uint8_t>& code) {
+    write_u32(out, code.size());
+    out.write((const char*)code.data(), code.size());
+}
+
+// Global ở định dạng v1: không có bảng tên global, GET_GLOBAL / SET_GLOBAL mang index constant chứa tên.
+// Hai proto giữ tên "answer" ở hai index constant khác nhau, loader phải gộp về cùng một slot.
+//   main:       answer = 40; r0 = get_answer(); HALT  (R0 = 42)
+//   get_answer: return answer + 2
+bool write_globals_v1(const char* path) {
+    std::ofstream out(path, std::ios::binary);
+    if (!out) return false;
+
+    // --- Header ---
+    write_u32(out, 0x4D454F57); // Magic "MEOW"
+    write_u32(out, 1);          // Version
+    write_u32(out, 0);          // Main Proto Index
+    write_u32(out, 2);          // Total Prototypes
+
+    // --- Prototype 0 (main) ---
+    write_u32(out, 4); // Num Registers
+    write_u32(out, 0); // Num Upvalues
+    write_u32(out, 0); // Name Index
+    write_u32(out, 3); // Pool Size
+    write_u8(out, 3); write_str(out, "main");
+    write_u8(out, 3); write_str(out, "answer");
+    write_u8(out, 4); write_u32(out, 1); // Tag Proto Ref -> proto 1
+    write_u32(out, 0); // Upvalue Descs
+
+    std::vector<uint8_t> code;
+    code.push_back((uint8_t)OpCode::LOAD_INT);    // LOAD_INT r1, 40
+    emit_u16(code, 1); emit_i64(code, 40);
+    code.push_back((uint8_t)OpCode::SET_GLOBAL);  // SET_GLOBAL "answer", r1
+    emit_u16(code, 1); emit_u16(code, 1);
+    code.push_back((uint8_t)OpCode::CLOSURE);     // CLOSURE r2, <get_answer>
+    emit_u16(code, 2); emit_u16(code, 2);
+    code.push_back((uint8_t)OpCode::CALL);        // CALL r0, r2, r3, 0
+    emit_u16(code, 0); emit_u16(code, 2); emit_u16(code, 3); emit_u16(code, 0);
+    code.push_back((uint8_t)OpCode::HALT);
+    write_code(out, code);
+
+    // --- Prototype 1 (get_answer) ---
+    write_u32(out, 2); // Num Registers
+    write_u32(out, 0); // Num Upvalues
+    write_u32(out, 0); // Name Index
+    write_u32(out, 3); // Pool Size
+    write_u8(out, 3); write_str(out, "get_answer");
+    write_u8(out, 3); write_str(out, "unused");
+    write_u8(out, 3); write_str(out, "answer");
+    write_u32(out, 0); // Upvalue Descs
+
+    code.clear();
+    code.push_back((uint8_t)OpCode::GET_GLOBAL);  // GET_GLOBAL r0, "answer"
+    emit_u16(code, 0); emit_u16(code, 2);
+    code.push_back((uint8_t)OpCode::LOAD_INT);    // LOAD_INT r1, 2
+    emit_u16(code, 1); emit_i64(code, 2);
+    code.push_back((uint8_t)OpCode::ADD);         // ADD r0, r0, r1
+    emit_u16(code, 0); emit_u16(code, 0); emit_u16(code, 1);
+    code.push_back((uint8_t)OpCode::RETURN);      // RETURN r0
+    emit_u16(code, 0);
+    write_code(out, code);
+
+    return true;
+}
+
+// Dùng opcode từ include/bytecode/op_codes.h nên fixture luôn khớp với VM đang build.
+// CMake build tool này cùng VM, scripts/run_tests.sh gọi nó để sinh fixture vào thư mục output rồi chạy.
+// Cách dùng: gen_bytecode [thư mục output] (mặc định: thư mục hiện tại)
+int main(int argc, char** argv) {
+    std::string dir = argc > 1 ? std::string(argv[1]) + "/" : "";
+    std::ofstream out(dir + "add_v1.meowb", std::ios::binary);
     if (!out) return 1;
 
     // --- Header ---
@@ -131,6 +167,9 @@ int main() {
     out.write((char*)code.data(), code.size());
 
     out.close();
-    std::cout << "Created test.meowb successfully!" << std::endl;
+    std::cout << "Created add_v1.meowb successfully!" << std::endl;
+
+    if (!write_globals_v1((dir + "globals_v1.meowb").c_str())) return 1;
+    std::cout << "Created globals_v1.meowb successfully!" << std::endl;
     return 0;
 }
\ No newline at end of file
@@ -53,6 +53,15 @@ enum class OpCode : uint8_t {
     THROW, SETUP_TRY, POP_TRY,
     // Modules
     IMPORT_MODULE, EXPORT, GET_EXPORT, IMPORT_ALL,
+    // VM-internal (quickened / superinstructions) - chỉ giữ chỗ để số opcode khớp với VM
+    ADD_II, ADD_FF, ADD_SS, SUB_II, SUB_FF, MUL_II, MUL_FF, DIV_FF, MOD_II,
+    EQ_II, EQ_FF, NEQ_II, NEQ_FF, GT_II, GT_FF, GE_II, GE_FF, LT_II, LT_FF, LE_II, LE_FF,
+    LOAD_INT_ADD, MOVE_MOVE, GET_PROP_MOVE, LT_JUMP_IF_FALSE,
+    // Compare-and-branch
+    JEQ, JNE, JLT, JLE,
+    JEQ_I, JNE_I, JLT_I, JLE_I, JGT_I, JGE_I,
+    TAIL_CALL,
+    INVOKE,
     
     TOTAL_OPCODES
 };
@@ -74,6 +83,10 @@ void init_op_map() {
     O(BIT_AND) O(BIT_OR) O(BIT_XOR) O(BIT_NOT) O(LSHIFT) O(RSHIFT)
     O(THROW) O(SETUP_TRY) O(POP_TRY)
     O(IMPORT_MODULE) O(EXPORT) O(GET_EXPORT) O(IMPORT_ALL)
+    O(JEQ) O(JNE) O(JLT) O(JLE)
+    O(JEQ_I) O(JNE_I) O(JLT_I) O(JLE_I) O(JGT_I) O(JGE_I)
+    O(TAIL_CALL)
+    O(INVOKE)
     #undef O
 }
 
@@ -257,6 +270,7 @@ struct Prototype {
     std::unordered_map<std::string, size_t> labels = {};
     std::vector<std::pair<size_t, std::string>> jump_patches = {};
     std::vector<std::pair<size_t, std::string>> try_patches = {};
+    std::vector<std::pair<size_t, uint16_t>> global_patches = {}; // {offset operand, index constant chứa tên}
 };
 
 // ============================================================================
@@ -271,6 +285,10 @@ class Assembler {
     Prototype* curr_proto_ = nullptr;
     std::unordered_map<std::string, uint32_t> proto_name_map_;
 
+    // Bảng global của cả file: tên -> slot (thứ tự ghi vào header)
+    std::unordered_map<std::string, uint32_t> global_symbols_;
+    std::vector<std::string> global_names_;
+
 public:
     Assembler(std::vector<Token> tokens) : tokens_(std::move(tokens)) {}
 
@@ -286,6 +304,7 @@ public:
 
         link_proto_refs();
         patch_labels();
+        resolve_globals();
         write_binary(output_file);
     }
 
@@ -414,7 +433,9 @@ private:
 
         auto parse_u16 = [&]() {
             Token t = consume(TokenType::NUMBER_INT, "Expected u16 operand");
-            emit_u16(static_cast<uint16_t>(std::stoi(t.lexeme)));
+            uint16_t value = static_cast<uint16_t>(std::stoi(t.lexeme));
+            emit_u16(value);
+            return value;
         };
 
         switch (op) {
@@ -448,6 +469,7 @@ private:
                 } else {
                     parse_u16();
                 }
+                if (op == OpCode::SETUP_TRY) parse_u16(); // error_reg (0xFFFF = không cần biến lỗi)
                 break;
             }
             case OpCode::JUMP_IF_FALSE: case OpCode::JUMP_IF_TRUE: {
@@ -462,9 +484,73 @@ private:
                 }
                 break;
             }
+            case OpCode::JEQ: case OpCode::JNE: case OpCode::JLT: case OpCode::JLE: {
+                parse_u16(); // r1
+                parse_u16(); // r2
+                Token target = peek();
+                if (target.type == TokenType::IDENTIFIER) {
+                    advance();
+                    curr_proto_->jump_patches.push_back({curr_proto_->bytecode.size(), target.lexeme});
+                    emit_u16(0xFFFF);
+                } else {
+                    parse_u16();
+                }
+                break;
+            }
+            case OpCode::JEQ_I: case OpCode::JNE_I: case OpCode::JLT_I:
+            case OpCode::JLE_I: case OpCode::JGT_I: case OpCode::JGE_I: {
+                parse_u16(); // reg
+                Token imm = consume(TokenType::NUMBER_INT, "Expected int64 immediate");
+                emit_u64(std::bit_cast<uint64_t>(static_cast<int64_t>(std::stoll(imm.lexeme))));
+                Token target = peek();
+                if (target.type == TokenType::IDENTIFIER) {
+                    advance();
+                    curr_proto_->jump_patches.push_back({curr_proto_->bytecode.size(), target.lexeme});
+                    emit_u16(0xFFFF);
+                } else {
+                    parse_u16();
+                }
+                break;
+            }
             case OpCode::RETURN:
                 parse_u16(); // Takes 1 arg (ret_reg)
                 break;
+            case OpCode::GET_GLOBAL: case OpCode::SET_GLOBAL: {
+                // Trong source vẫn viết index constant chứa tên; resolve_globals() đổi thành slot
+                if (op == OpCode::GET_GLOBAL) parse_u16(); // dst
+                size_t offset = curr_proto_->bytecode.size();
+                uint16_t name_idx = parse_u16();
+                curr_proto_->global_patches.push_back({offset, name_idx});
+                if (op == OpCode::SET_GLOBAL) parse_u16(); // src
+                break;
+            }
+            case OpCode::CALL: case OpCode::CALL_VOID: case OpCode::TAIL_CALL: {
+                // Quy ước register: khối args phải nằm trong .registers của hàm gọi. VM chỉ đặt cửa sổ
+                // của callee chồng lên khối args (từ fn_reg nếu fn_reg == arg_start - 1, chừa chỗ cho self)
+                // khi mọi register từ đó trở lên chắc chắn không còn được đọc sau lời gọi; nếu không thì copy.
+                if (op == OpCode::CALL) parse_u16(); // dst
+                parse_u16(); // fn_reg
+                uint16_t arg_start = parse_u16();
+                uint16_t argc = parse_u16();
+                if (static_cast<uint32_t>(arg_start) + argc > curr_proto_->num_regs) {
+                    throw std::runtime_error("CALL arguments r" + std::to_string(arg_start) + "..r" + std::to_string(arg_start + argc - 1) +
+                                             " exceed .registers " + std::to_string(curr_proto_->num_regs));
+                }
+                break;
+            }
+            case OpCode::INVOKE: {
+                // INVOKE dst obj_reg name_idx arg_start argc: self được ghi vào obj_reg nếu obj_reg == arg_start - 1
+                parse_u16(); // dst
+                parse_u16(); // obj_reg
+                parse_u16(); // name_idx
+                uint16_t arg_start = parse_u16();
+                uint16_t argc = parse_u16();
+                if (static_cast<uint32_t>(arg_start) + argc > curr_proto_->num_regs) {
+                    throw std::runtime_error("INVOKE arguments r" + std::to_string(arg_start) + "..r" + std::to_string(arg_start + argc - 1) +
+                                             " exceed .registers " + std::to_string(curr_proto_->num_regs));
+                }
+                break;
+            }
             
             default: {
                 // Heuristic for other opcodes based on generic arity
@@ -486,7 +572,7 @@ private:
             case OpCode::GET_UPVALUE: case OpCode::SET_UPVALUE: case OpCode::CLOSURE:
             case OpCode::NEW_CLASS: case OpCode::NEW_INSTANCE: case OpCode::IMPORT_MODULE:
             case OpCode::EXPORT: case OpCode::GET_KEYS: case OpCode::GET_VALUES:
-            case OpCode::GET_SUPER: case OpCode::GET_EXPORT: 
+            case OpCode::GET_SUPER: case OpCode::INHERIT:
                 return 2;
             case OpCode::ADD: case OpCode::SUB: case OpCode::MUL: case OpCode::DIV:
             case OpCode::MOD: case OpCode::POW: case OpCode::EQ: case OpCode::NEQ:
@@ -495,7 +581,7 @@ private:
             case OpCode::LSHIFT: case OpCode::RSHIFT: 
             case OpCode::NEW_ARRAY: case OpCode::NEW_HASH: case OpCode::GET_INDEX:
             case OpCode::SET_INDEX: case OpCode::GET_PROP: case OpCode::SET_PROP:
-            case OpCode::SET_METHOD: case OpCode::CALL_VOID:
+            case OpCode::SET_METHOD: case OpCode::CALL_VOID: case OpCode::GET_EXPORT:
                 return 3;
             case OpCode::CALL: return 4;
             default: return 0;
@@ -533,6 +619,23 @@ private:
         }
     }
 
+    void resolve_globals() {
+        for (auto& p : protos_) {
+            for (const auto& [offset, name_idx] : p.global_patches) {
+                if (name_idx >= p.constants.size() || p.constants[name_idx].type != ConstType::STRING_T) {
+                    throw std::runtime_error("GET_GLOBAL/SET_GLOBAL in '" + p.name + "': constant " + std::to_string(name_idx) +
+                                             " is not a string");
+                }
+                const std::string& name = p.constants[name_idx].val_str;
+                auto [it, inserted] = global_symbols_.emplace(name, static_cast<uint32_t>(global_names_.size()));
+                if (inserted) global_names_.push_back(name);
+                if (it->second > 0xFFFF) throw std::runtime_error("Too many globals (limit is 65536)");
+                p.bytecode[offset] = it->second & 0xFF;
+                p.bytecode[offset + 1] = (it->second >> 8) & 0xFF;
+            }
+        }
+    }
+
     void write_binary(const std::string& filename) {
         std::ofstream out(filename, std::ios::binary);
         if (!out) throw std::runtime_error("Cannot open output file");
@@ -551,7 +654,11 @@ private:
 
         // Header
         write_u32(0x4D454F57); // Magic
-        write_u32(1);          // Version
+        write_u32(2);          // Version
+
+        // Global table (slot = vị trí trong bảng)
+        write_u32(global_names_.size());
+        for (const auto& name : global_names_) write_str(name);
         
         // Main Proto Index
         if (proto_name_map_.count("main")) write_u32(proto_name_map_["main"]);
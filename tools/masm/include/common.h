@@ -33,6 +33,15 @@ enum class OpCode : uint8_t {
     THROW, SETUP_TRY, POP_TRY,
     // Modules
     IMPORT_MODULE, EXPORT, GET_EXPORT, IMPORT_ALL,
+    // VM-internal (quickened / superinstructions) - chỉ giữ chỗ để số opcode khớp với VM
+    ADD_II, ADD_FF, ADD_SS, SUB_II, SUB_FF, MUL_II, MUL_FF, DIV_FF, MOD_II,
+    EQ_II, EQ_FF, NEQ_II, NEQ_FF, GT_II, GT_FF, GE_II, GE_FF, LT_II, LT_FF, LE_II, LE_FF,
+    LOAD_INT_ADD, MOVE_MOVE, GET_PROP_MOVE, LT_JUMP_IF_FALSE,
+    // Compare-and-branch
+    JEQ, JNE, JLT, JLE,
+    JEQ_I, JNE_I, JLT_I, JLE_I, JGT_I, JGE_I,
+    TAIL_CALL,
+    INVOKE,
     
     TOTAL_OPCODES
 };
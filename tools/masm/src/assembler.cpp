@@ -137,16 +137,21 @@ void Assembler::parse_instruction() {
 
     auto parse_u16 = [&]() {
         Token t = consume(TokenType::NUMBER_INT, "Expected u16");
-        emit_u16(static_cast<uint16_t>(std::stoi(std::string(t.lexeme))));
+        uint16_t value = static_cast<uint16_t>(std::stoi(std::string(t.lexeme)));
+        emit_u16(value);
+        return value;
     };
 
     // [OPTIMIZATION] Xử lý riêng cho Global: Dùng Index thay vì Constant Pool
+    // GET_GLOBAL dst name / SET_GLOBAL name src (format v2: operand là slot u16)
     if (op == OpCode::GET_GLOBAL || op == OpCode::SET_GLOBAL) {
+        if (op == OpCode::GET_GLOBAL) parse_u16(); // dst
         Token t = consume(TokenType::IDENTIFIER, "Expected global variable name");
         // Giải quyết tên -> index ngay tại compile time
         uint32_t global_idx = resolve_global(t.lexeme);
-        // Emit u32 index (để hỗ trợ > 65k globals nếu cần, hoặc dùng u16 cũng được, ở đây dùng u32 cho an toàn)
-        emit_u32(global_idx);
+        if (global_idx > 0xFFFF) throw std::runtime_error("Too many globals (limit is 65536)");
+        emit_u16(static_cast<uint16_t>(global_idx));
+        if (op == OpCode::SET_GLOBAL) parse_u16(); // src
         return;
     }
 
@@ -173,6 +178,7 @@ void Assembler::parse_instruction() {
                 curr_proto_->try_patches.push_back({curr_proto_->bytecode.size(), std::string(target.lexeme)});
                 emit_u16(0xFFFF);
             } else parse_u16();
+            if (op == OpCode::SETUP_TRY) parse_u16(); // error_reg (0xFFFF = không cần biến lỗi)
             break;
         }
         case OpCode::JUMP_IF_FALSE: case OpCode::JUMP_IF_TRUE: {
@@ -184,6 +190,57 @@ void Assembler::parse_instruction() {
             } else parse_u16();
             break;
         }
+        case OpCode::JEQ: case OpCode::JNE: case OpCode::JLT: case OpCode::JLE: {
+            parse_u16(); // r1
+            parse_u16(); // r2
+            if (peek().type == TokenType::IDENTIFIER) {
+                Token target = advance();
+                curr_proto_->jump_patches.push_back({curr_proto_->bytecode.size(), std::string(target.lexeme)});
+                emit_u16(0xFFFF);
+            } else parse_u16();
+            break;
+        }
+        case OpCode::JEQ_I: case OpCode::JNE_I: case OpCode::JLT_I:
+        case OpCode::JLE_I: case OpCode::JGT_I: case OpCode::JGE_I: {
+            parse_u16(); // reg
+            Token t = consume(TokenType::NUMBER_INT, "Expected int64 immediate");
+            int64_t val;
+            std::from_chars(t.lexeme.data(), t.lexeme.data() + t.lexeme.size(), val);
+            emit_u64(std::bit_cast<uint64_t>(val));
+            if (peek().type == TokenType::IDENTIFIER) {
+                Token target = advance();
+                curr_proto_->jump_patches.push_back({curr_proto_->bytecode.size(), std::string(target.lexeme)});
+                emit_u16(0xFFFF);
+            } else parse_u16();
+            break;
+        }
+        case OpCode::CALL: case OpCode::CALL_VOID: case OpCode::TAIL_CALL: {
+            // Quy ước register: cửa sổ của callee đặt chồng lên khối args (bắt đầu từ fn_reg nếu
+            // fn_reg == arg_start - 1, để chừa chỗ cho self của method / constructor). Khối args phải
+            // nằm trong .registers của hàm gọi; mọi register >= arg_start bị ghi đè sau lời gọi.
+            if (op == OpCode::CALL) parse_u16(); // dst
+            parse_u16(); // fn_reg
+            uint16_t arg_start = parse_u16();
+            uint16_t argc = parse_u16();
+            if (static_cast<uint32_t>(arg_start) + argc > curr_proto_->num_regs) {
+                throw std::runtime_error("CALL arguments r" + std::to_string(arg_start) + "..r" + std::to_string(arg_start + argc - 1) +
+                                         " exceed .registers " + std::to_string(curr_proto_->num_regs));
+            }
+            break;
+        }
+        case OpCode::INVOKE: {
+            // INVOKE dst obj_reg name_idx arg_start argc: self được ghi vào obj_reg nếu obj_reg == arg_start - 1
+            parse_u16(); // dst
+            parse_u16(); // obj_reg
+            parse_u16(); // name_idx
+            uint16_t arg_start = parse_u16();
+            uint16_t argc = parse_u16();
+            if (static_cast<uint32_t>(arg_start) + argc > curr_proto_->num_regs) {
+                throw std::runtime_error("INVOKE arguments r" + std::to_string(arg_start) + "..r" + std::to_string(arg_start + argc - 1) +
+                                         " exceed .registers " + std::to_string(curr_proto_->num_regs));
+            }
+            break;
+        }
         default: {
             int args = get_arity(op);
             for(int i=0; i<args; ++i) parse_u16();
@@ -200,7 +257,7 @@ int Assembler::get_arity(OpCode op) {
         case OpCode::BIT_NOT: case OpCode::GET_UPVALUE: case OpCode::SET_UPVALUE: case OpCode::CLOSURE:
         case OpCode::NEW_CLASS: case OpCode::NEW_INSTANCE: case OpCode::IMPORT_MODULE:
         case OpCode::EXPORT: case OpCode::GET_KEYS: case OpCode::GET_VALUES:
-        case OpCode::GET_SUPER: case OpCode::GET_EXPORT: return 2;
+        case OpCode::GET_SUPER: case OpCode::INHERIT: return 2;
         // GET/SET_GLOBAL đã được handle riêng ở trên
         case OpCode::ADD: case OpCode::SUB: case OpCode::MUL: case OpCode::DIV:
         case OpCode::MOD: case OpCode::POW: case OpCode::EQ: case OpCode::NEQ:
@@ -209,7 +266,7 @@ int Assembler::get_arity(OpCode op) {
         case OpCode::LSHIFT: case OpCode::RSHIFT: 
         case OpCode::NEW_ARRAY: case OpCode::NEW_HASH: case OpCode::GET_INDEX:
         case OpCode::SET_INDEX: case OpCode::GET_PROP: case OpCode::SET_PROP:
-        case OpCode::SET_METHOD: case OpCode::CALL_VOID:
+        case OpCode::SET_METHOD: case OpCode::CALL_VOID: case OpCode::GET_EXPORT:
             return 3;
         case OpCode::CALL: return 4;
         default: return 0;
@@ -253,10 +310,13 @@ void Assembler::write_binary(const std::string& filename) {
     auto write_str = [&](const std::string& s) { write_u32(s.size()); out.write(s.data(), s.size()); };
 
     write_u32(0x4D454F57); // Magic
-    write_u32(1);          // Version
+    write_u32(2);          // Version
 
-    // [NEW] Ghi số lượng biến Global vào Header để VM allocate vector
-    write_u32(static_cast<uint32_t>(global_symbols_.size()));
+    // [NEW] Ghi bảng tên Global vào Header (thứ tự = slot) để VM allocate vector
+    std::vector<std::string> global_names(global_symbols_.size());
+    for (const auto& [name, index] : global_symbols_) global_names[index] = name;
+    write_u32(static_cast<uint32_t>(global_names.size()));
+    for (const auto& name : global_names) write_str(name);
     std::cout << "[Info] Total Globals: " << global_symbols_.size() << "\n";
 
     if (proto_name_map_.count("main")) write_u32(proto_name_map_["main"]);
@@ -18,6 +18,10 @@ void init_op_map() {
     O(BIT_AND) O(BIT_OR) O(BIT_XOR) O(BIT_NOT) O(LSHIFT) O(RSHIFT)
     O(THROW) O(SETUP_TRY) O(POP_TRY)
     O(IMPORT_MODULE) O(EXPORT) O(GET_EXPORT) O(IMPORT_ALL)
+    O(JEQ) O(JNE) O(JLT) O(JLE)
+    O(JEQ_I) O(JNE_I) O(JLT_I) O(JLE_I) O(JGT_I) O(JGE_I)
+    O(TAIL_CALL)
+    O(INVOKE)
     #undef O
 }
 